@@ -45,6 +45,7 @@
 - (void)setup;
 - (void)reset;
 - (void)resetHighlight;
+- (void)prepareForReuse;
 
 - (void)positionInFrame:(CGRect)targetRect onView:(NSView *)aView pageSize:(CGSize)pageSize;
 - (void)reposition;
@@ -64,5 +65,8 @@
 - (NSSet *)areasAtPoint:(CGPoint)point;
 
 + (Class)registeredClassForType:(NSString *)aType;
++ (CHChartAreaView *)dequeueReusableViewForType:(NSString *)aType;
++ (void)enqueueReusableView:(CHChartAreaView *)view;
++ (void)drainReusePool;
 
 @end
@@ -27,8 +27,12 @@
 #import "CHOutlineView.h"
 
 
+static const NSUInteger kCHChartAreaViewReusePoolLimit = 32;			///< Max number of views per type we keep around for reuse
+
+
 @interface CHChartAreaView () {
 	CGRect inParentRect;
+	BOOL enqueued;						// YES while the view sits in the reuse pool
 }
 
 @property (nonatomic, weak) CHOutlineView *outlineView;
@@ -106,6 +110,37 @@
 	}
 }
 
+/**
+ *  Called when the receiver is put into the reuse pool; detaches it from its area and view hierarchy and resets it, so it can be bound to another area.
+ *
+ *  Sub-area views are not kept but put back into the pool individually, since the next area may have an entirely different set of sub-areas.
+ *  @attention If you override this method, call super implementation.
+ */
+- (void)prepareForReuse
+{
+	for (CHChartAreaView *area in _areas) {
+		[CHChartAreaView enqueueReusableView:area];
+	}
+	self.areas = nil;
+	
+	if (self == _pageView.activeArea) {
+		_pageView.activeArea = nil;
+	}
+	if (self == [[self window] firstResponder]) {
+		[[self window] makeFirstResponder:nil];
+	}
+	[self reset];
+	[self resetHighlight];
+	[self removeFromSuperview];
+	
+	[_area forgetView:self];
+	self.area = nil;
+	self.outline = nil;
+	self.pageView = nil;
+	self.pageSize = CGSizeZero;
+	inParentRect = CGRectZero;
+}
+
 /**
  *  Call this to update the area.
  *
@@ -198,7 +233,7 @@
 				[newAreas addObject:sibling];
 			}
 			else {
-				[sibling removeFromSuperview];
+				[CHChartAreaView enqueueReusableView:sibling];
 			}
 		}
 		self.areas = ([newAreas count] > 0) ? newAreas : nil;
@@ -239,10 +274,10 @@
 			inParentRect = CGRectMake(0.f, 0.f, 1.f, 1.f);
 		}
 		
-		// update relative frame
+		// update relative frame; the parent rect is the page frame in document view coordinates for topmost areas, so it's not at the origin
 		CGRect relFrame = CGRectZero;
-		relFrame.origin.x = frameRect.origin.x / inParentRect.size.width;
-		relFrame.origin.y = frameRect.origin.y / inParentRect.size.height;
+		relFrame.origin.x = (frameRect.origin.x - inParentRect.origin.x) / inParentRect.size.width;
+		relFrame.origin.y = (frameRect.origin.y - inParentRect.origin.y) / inParentRect.size.height;
 		relFrame.size.width = frameRect.size.width / inParentRect.size.width;
 		relFrame.size.height = frameRect.size.height / inParentRect.size.height;
 		
@@ -351,18 +386,16 @@
 - (NSBezierPath *)outline
 {
 	if (!_outline) {
-		if ([self.area.outlinePoints count] > 0) {
-			NSBezierPath *path = nil;
+		NSData *outlineData = self.area.outlineData;
+		NSUInteger count = [outlineData length] / sizeof(CGPoint);
+		if (count > 0) {
+			const CGPoint *points = [outlineData bytes];
+			NSBezierPath *path = [NSBezierPath new];
 			
 			// create the path
-			for (NSValue *pointValue in self.area.outlinePoints) {
-				if (!path) {
-					path = [NSBezierPath new];
-					[path moveToPoint:[pointValue pointValue]];
-				}
-				else {
-					[path lineToPoint:[pointValue pointValue]];
-				}
+			[path moveToPoint:NSPointFromCGPoint(points[0])];
+			for (NSUInteger i = 1; i < count; i++) {
+				[path lineToPoint:NSPointFromCGPoint(points[i])];
 			}
 			
 			[path closePath];
@@ -430,9 +463,56 @@
 	}
 	
 	[NSBezierPath fillRect:self.bounds];
+	
+	// plot areas with a stats source preview their percentile curves
+	if ([@"plot" isEqualToString:_area.type] && [_area.statsSource length] > 0) {
+		[self drawPercentileCurves];
+	}
 	[NSGraphicsContext restoreGraphicsState];
 }
 
+- (void)drawPercentileCurves
+{
+	static NSArray *percentiles = nil;
+	if (!percentiles) {
+		percentiles = @[@3, @10, @25, @50, @75, @90, @97];
+	}
+	
+	NSRect bounds = self.bounds;
+	NSSize pixelSize = [self convertSizeToBacking:bounds.size];
+	NSArray *curves = [_area percentileCurves:percentiles forGender:_area.chart.gender pixelSize:pixelSize];
+	if ([curves count] < 1) {
+		return;
+	}
+	
+	NSBezierPath *path = [NSBezierPath bezierPath];
+	for (NSData *curve in curves) {
+		const CGPoint *points = [curve bytes];
+		NSUInteger count = [curve length] / sizeof(CGPoint);
+		BOOL startSubpath = YES;
+		for (NSUInteger i = 0; i < count; i++) {
+			if (!isfinite(points[i].x) || !isfinite(points[i].y)) {			// gap in the source's data
+				startSubpath = YES;
+				continue;
+			}
+			
+			NSPoint point = NSMakePoint(NSMinX(bounds) + points[i].x * NSWidth(bounds), NSMinY(bounds) + points[i].y * NSHeight(bounds));
+			if (startSubpath) {
+				[path moveToPoint:point];
+				startSubpath = NO;
+			}
+			else {
+				[path lineToPoint:point];
+			}
+		}
+	}
+	
+	[NSBezierPath clipRect:bounds];
+	[[NSColor colorWithDeviceRed:0.f green:0.f blue:0.f alpha:0.6f] setStroke];
+	[path setLineWidth:1.f];
+	[path stroke];
+}
+
 
 
 #pragma mark - Class Registration
@@ -443,6 +523,76 @@
 
 
 
+#pragma mark - Reuse Pool
+/**
+ *  The pool of reusable views, holding one array per area type. Only to be used from the main thread.
+ */
++ (NSMutableDictionary *)reusePool
+{
+	static NSMutableDictionary *reusePool = nil;
+	if (!reusePool) {
+		reusePool = [NSMutableDictionary new];
+	}
+	return reusePool;
+}
+
+/**
+ *  Returns a view previously put into the pool for an area of the given type, nil if there is none.
+ *
+ *  The view has been reset and is not bound to any area; set its "area" property before use.
+ */
++ (CHChartAreaView *)dequeueReusableViewForType:(NSString *)aType
+{
+	NSMutableArray *pool = [self reusePool][(aType ? aType : @"")];
+	CHChartAreaView *view = [pool lastObject];
+	if (view) {
+		[pool removeLastObject];
+		view->enqueued = NO;
+	}
+	return view;
+}
+
+/**
+ *  Resets the view (and its sub-area views) and keeps it around to be reused for another area of the same type.
+ *
+ *  Views that are already pooled or no longer bound to an area (i.e. have been enqueued before) are ignored, so a view never ends up in a pool twice.
+ */
++ (void)enqueueReusableView:(CHChartAreaView *)view
+{
+	if (!view || view->enqueued || !view.area) {
+		return;
+	}
+	
+	NSString *type = view.area.type ? view.area.type : @"";
+	[view prepareForReuse];
+	
+	NSMutableDictionary *reusePool = [self reusePool];
+	NSMutableArray *pool = reusePool[type];
+	if (!pool) {
+		pool = [NSMutableArray array];
+		reusePool[type] = pool;
+	}
+	if ([pool count] < kCHChartAreaViewReusePoolLimit) {
+		[pool addObject:view];
+		view->enqueued = YES;
+	}
+}
+
+/**
+ *  Releases all pooled views, e.g. when a chart window closes.
+ */
++ (void)drainReusePool
+{
+	for (NSArray *pool in [[self reusePool] allValues]) {
+		for (CHChartAreaView *view in pool) {
+			view->enqueued = NO;
+		}
+	}
+	[[self reusePool] removeAllObjects];
+}
+
+
+
 #pragma mark - Utilities
 - (NSString *)description
 {
@@ -26,13 +26,17 @@
 #import "CHChartAreaView.h"
 
 
-@interface CHChartPDFView (){
-	CGSize lastSizeWhenPositioningAreas;
-}
+@interface CHChartPDFView ()
 
 @property (nonatomic, strong) NSButton *zoomIn;
 @property (nonatomic, strong) NSButton *zoomOut;
 
+@property (nonatomic, copy) NSDictionary *areasByPage;						///< NSArray of top-level CHChartArea per page number, prepared in the background
+@property (nonatomic, strong) NSMutableDictionary *positionedPageFrames;	///< The page frame (in document view coordinates) we last positioned the areas of a page in
+@property (nonatomic, strong) NSMutableDictionary *shownAreaViews;			///< NSArray of CHChartAreaView per page number that are currently instantiated
+@property (nonatomic, assign) NSUInteger areaIndexGeneration;				///< Bumped whenever an index being prepared in the background becomes stale
+@property (nonatomic, weak) NSClipView *observedClipView;					///< The clip view of our scroll view whose bounds we observe
+
 @end
 
 
@@ -41,43 +45,181 @@
 
 - (void)dealloc
 {
+	[[NSNotificationCenter defaultCenter] removeObserver:self];
 	self.activeArea = nil;
 }
 
 
 
+#pragma mark - Chart and Page Index
+- (void)setChart:(CHChart *)chart
+{
+	if (chart != _chart) {
+		self.activeArea = nil;
+		[self releaseAreaViewsOnPages:[_shownAreaViews allKeys]];
+		_chart = chart;
+		
+		[self prepareAreaIndex];
+	}
+}
+
+/**
+ *  Groups the chart's top-level areas by page on a background queue, then asks for a redraw so the visible pages can create their area views.
+ */
+- (void)prepareAreaIndex
+{
+	self.areasByPage = nil;
+	[_positionedPageFrames removeAllObjects];
+	NSUInteger generation = ++_areaIndexGeneration;
+	
+	CHChart *chart = _chart;
+	NSSet *areas = [chart.chartAreas copy];
+	if ([areas count] < 1) {
+		return;
+	}
+	
+	__weak CHChartPDFView *this = self;
+	dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+		NSDictionary *index = [CHChartPDFView areasByPageFromAreas:areas];
+		
+		dispatch_async(dispatch_get_main_queue(), ^{
+			if (this.chart == chart && generation == this.areaIndexGeneration) {
+				this.areasByPage = index;
+				[this setNeedsDisplay:YES];
+			}
+		});
+	});
+}
+
++ (NSDictionary *)areasByPageFromAreas:(id<NSFastEnumeration>)areas
+{
+	NSMutableDictionary *index = [NSMutableDictionary dictionary];
+	for (CHChartArea *area in areas) {
+		NSNumber *pageNum = @([self pageNumberForArea:area]);
+		NSMutableArray *onPage = index[pageNum];
+		if (!onPage) {
+			onPage = [NSMutableArray array];
+			index[pageNum] = onPage;
+		}
+		[onPage addObject:area];
+	}
+	return index;
+}
+
+/**
+ *  Areas that don't specify a page reside on the first page.
+ */
++ (NSUInteger)pageNumberForArea:(CHChartArea *)area
+{
+	return [self pageNumberForPage:area.page];
+}
+
++ (NSUInteger)pageNumberForPage:(NSUInteger)page
+{
+	return (page > 0 && NSNotFound != page) ? page : 1;
+}
+
+/**
+ *  The page frame in the coordinate system of our document view.
+ */
+- (NSRect)frameForPage:(PDFPage *)page
+{
+	NSRect pageBounds = [page boundsForBox:[self displayBox]];					// kPDFDisplayBoxCropBox is our default display mode, not kPDFDisplayBoxMediaBox
+	NSRect inSelf = [self convertRect:pageBounds fromPage:page];
+	return [self convertRect:inSelf toView:[self documentView]];
+}
+
+
+
 #pragma mark - PDF Drawing
 /**
- *  Called after the page has been drawn
+ *  Called after the page has been drawn, only for pages that are (at least partially) visible.
+ *
+ *  This is where area views get instantiated, so pages the user never scrolls to never get any views.
  */
 - (void)drawPagePost:(PDFPage *)page
 {
-	NSView *docView = [self documentView];
-	if (CGSizeEqualToSize(lastSizeWhenPositioningAreas, docView.bounds.size)) {
+	NSUInteger pageNum = [self.document indexForPage:page] + 1;
+	NSRect pageFrame = [self frameForPage:page];
+	NSValue *positioned = _positionedPageFrames[@(pageNum)];
+	if (positioned && NSEqualRects(pageFrame, [positioned rectValue])) {
 		return;
 	}
 	
-	NSUInteger pageNum = [self.document indexForPage:page] + 1;
-	NSSize pageSize = [self rowSizeForPage:page];
-	NSRect pageFrame = NSMakeRect(0.f, 0.f, pageSize.width, pageSize.height);
-	NSSize origSize = [page boundsForBox:[self displayBox]].size;				// kPDFDisplayBoxCropBox is our default display mode, not kPDFDisplayBoxMediaBox
-	
-	// add/reposition our areas
-	NSSet *areas = _chart.chartAreas;
-	if ([areas count] > 0) {
-		for (CHChartArea *area in areas) {
-			if (!area.page || pageNum == area.page) {
-				CHChartAreaView *areaView = [area viewForParent:self];
-				areaView.pageView = self;
-				[areaView positionInFrame:pageFrame onView:docView pageSize:origSize];
-			}
-			else {
-				DLog(@"Skipping area %@, not on page %lu", area, pageNum);
-			}
+	// index not yet ready, we will be redrawn once it is
+	if (!_areasByPage) {
+		return;
+	}
+	
+	[self positionAreasOnPage:page pageNumber:pageNum inFrame:pageFrame];
+}
+
+/**
+ *  Creates (if necessary) and positions the views for all top-level areas on the given page.
+ *
+ *  Views already shown on the page stay tracked even if the index doesn't (yet) know about their area, e.g. when they were added while the index was
+ *  being prepared.
+ */
+- (void)positionAreasOnPage:(PDFPage *)page pageNumber:(NSUInteger)pageNum inFrame:(NSRect)pageFrame
+{
+	NSView *docView = [self documentView];
+	NSSize origSize = [page boundsForBox:[self displayBox]].size;
+	
+	NSArray *areas = _areasByPage[@(pageNum)];
+	NSMutableArray *views = [NSMutableArray arrayWithArray:_shownAreaViews[@(pageNum)]];
+	for (CHChartArea *area in areas) {
+		CHChartAreaView *areaView = [area viewForParent:self];
+		if (areaView && ![views containsObject:areaView]) {
+			[views addObject:areaView];
 		}
 	}
+	for (CHChartAreaView *areaView in views) {
+		areaView.pageView = self;
+		[areaView positionInFrame:pageFrame onView:docView pageSize:origSize];
+	}
 	
-	lastSizeWhenPositioningAreas = docView.bounds.size;
+	if (!_shownAreaViews) {
+		self.shownAreaViews = [NSMutableDictionary dictionary];
+	}
+	if (!_positionedPageFrames) {
+		self.positionedPageFrames = [NSMutableDictionary dictionary];
+	}
+	_shownAreaViews[@(pageNum)] = views;
+	_positionedPageFrames[@(pageNum)] = [NSValue valueWithRect:pageFrame];
+}
+
+/**
+ *  Called whenever our visible rect may have changed; releases area views on pages that scrolled out of view.
+ */
+- (void)visibleRectDidChange:(NSNotification *)notification
+{
+	NSMutableSet *hidden = [NSMutableSet setWithArray:[_shownAreaViews allKeys]];
+	for (PDFPage *page in [self visiblePages]) {
+		[hidden removeObject:@([self.document indexForPage:page] + 1)];
+	}
+	[self releaseAreaViewsOnPages:[hidden allObjects]];
+}
+
+/**
+ *  Removes the area views on the given pages from the view hierarchy, except for the page holding the active area.
+ *
+ *  The views are put into the reuse pool, so scrolling back to the page or showing another chart doesn't need to build them from scratch.
+ */
+- (void)releaseAreaViewsOnPages:(NSArray *)pageNumbers
+{
+	CHChartAreaView *activeTopmost = [self activeTopmostView];
+	for (NSNumber *pageNum in pageNumbers) {
+		NSArray *views = _shownAreaViews[pageNum];
+		if (activeTopmost && [views containsObject:activeTopmost]) {
+			continue;
+		}
+		
+		for (CHChartAreaView *areaView in views) {
+			[CHChartAreaView enqueueReusableView:areaView];
+		}
+		[_shownAreaViews removeObjectForKey:pageNum];
+		[_positionedPageFrames removeObjectForKey:pageNum];
+	}
 }
 
 
@@ -85,9 +227,52 @@
 #pragma mark - View Tasks
 - (void)viewWillMoveToSuperview:(NSView *)newSuperview
 {
+	NSNotificationCenter *center = [NSNotificationCenter defaultCenter];
+	[center removeObserver:self name:PDFViewScaleChangedNotification object:self];
+	[center removeObserver:self name:PDFViewPageChangedNotification object:self];
+	[center removeObserver:self name:CHChartAreaPageDidChangeNotification object:nil];
+	
 	if (newSuperview) {
 		[self addSubview:self.zoomIn];
 		[self addSubview:self.zoomOut];
+		
+		// we instantiate area views only for visible pages, so we need to know when that changes
+		[center addObserver:self selector:@selector(visibleRectDidChange:) name:PDFViewScaleChangedNotification object:self];
+		[center addObserver:self selector:@selector(visibleRectDidChange:) name:PDFViewPageChangedNotification object:self];
+		[center addObserver:self selector:@selector(areaPageDidChange:) name:CHChartAreaPageDidChangeNotification object:nil];
+	}
+}
+
+- (void)viewDidMoveToSuperview
+{
+	[super viewDidMoveToSuperview];
+	[self observeClipView];
+}
+
+- (void)setDocument:(PDFDocument *)document
+{
+	[super setDocument:document];
+	[self observeClipView];
+}
+
+/**
+ *  Observes bounds changes of our own scroll view's clip view only, which is what scrolling changes.
+ */
+- (void)observeClipView
+{
+	NSClipView *clipView = [self superview] ? [[[self documentView] enclosingScrollView] contentView] : nil;
+	if (clipView == _observedClipView) {
+		return;
+	}
+	
+	NSNotificationCenter *center = [NSNotificationCenter defaultCenter];
+	if (_observedClipView) {
+		[center removeObserver:self name:NSViewBoundsDidChangeNotification object:_observedClipView];
+	}
+	self.observedClipView = clipView;
+	if (clipView) {
+		[clipView setPostsBoundsChangedNotifications:YES];
+		[center addObserver:self selector:@selector(visibleRectDidChange:) name:NSViewBoundsDidChangeNotification object:clipView];
 	}
 }
 
@@ -114,6 +299,18 @@
 
 
 #pragma mark - Area Handling
+/**
+ *  The top-level view containing the active area view, if any.
+ */
+- (CHChartAreaView *)activeTopmostView
+{
+	CHChartAreaView *activeTopmost = _activeArea;
+	while ([[activeTopmost superview] isKindOfClass:[CHChartAreaView class]]) {
+		activeTopmost = (CHChartAreaView *)[activeTopmost superview];
+	}
+	return activeTopmost;
+}
+
 - (void)setActiveArea:(CHChartAreaView *)activeArea
 {
 	if (activeArea != _activeArea) {
@@ -152,16 +349,45 @@
 		return nil;
 	}
 	
-	// place
-	NSView *docView = [self documentView];
-	PDFPage *currentPage = [self.document pageAtIndex:0];		// TODO: support multi-page docs
-	NSSize pageSize = [self rowSizeForPage:currentPage];
-	NSRect pageFrame = NSMakeRect(0.f, 0.f, pageSize.width, pageSize.height);
-	NSSize origSize = [currentPage boundsForBox:[self displayBox]].size;
+	// find the page
+	NSUInteger pageNum = [[self class] pageNumberForArea:area];
+	if (pageNum > [self.document pageCount]) {
+		DLog(@"Area %@ is on page %lu, but the document only has %lu pages", area, (unsigned long)pageNum, (unsigned long)[self.document pageCount]);
+		return nil;
+	}
+	PDFPage *page = [self.document pageAtIndex:pageNum - 1];
+	
+	// update the index; one still being prepared may not contain the area, start over
+	if (_areasByPage) {
+		NSMutableDictionary *index = [_areasByPage mutableCopy];
+		NSArray *onPage = index[@(pageNum)];
+		if (![onPage containsObject:area]) {
+			index[@(pageNum)] = onPage ? [onPage arrayByAddingObject:area] : @[area];
+			self.areasByPage = index;
+		}
+	}
+	else {
+		[self prepareAreaIndex];
+	}
+	
+	// place on its page, showing that page first
+	if (![[self visiblePages] containsObject:page]) {
+		[self goToPage:page];
+	}
 	
+	NSRect pageFrame = [self frameForPage:page];
+	NSSize origSize = [page boundsForBox:[self displayBox]].size;
 	CHChartAreaView *areaView = [area viewForParent:self];
 	areaView.pageView = self;
-	[areaView positionInFrame:pageFrame onView:docView pageSize:origSize];
+	[areaView positionInFrame:pageFrame onView:[self documentView] pageSize:origSize];
+	
+	if (!_shownAreaViews) {
+		self.shownAreaViews = [NSMutableDictionary dictionary];
+	}
+	NSArray *shown = _shownAreaViews[@(pageNum)];
+	if (![shown containsObject:areaView]) {
+		_shownAreaViews[@(pageNum)] = shown ? [shown arrayByAddingObject:areaView] : @[areaView];
+	}
 	
 	// first responder and return
 	[areaView makeFirstResponder];
@@ -174,12 +400,94 @@
  */
 - (void)didRemoveArea:(CHChartArea *)area
 {
+	NSNumber *pageNum = @([[self class] pageNumberForArea:area]);
+	
+	// update the index
+	NSArray *onPage = _areasByPage[pageNum];
+	if ([onPage containsObject:area]) {
+		NSMutableDictionary *index = [_areasByPage mutableCopy];
+		NSMutableArray *remaining = [onPage mutableCopy];
+		[remaining removeObject:area];
+		index[pageNum] = remaining;
+		self.areasByPage = index;
+	}
+	else if (!_areasByPage) {
+		[self prepareAreaIndex];
+	}
+	
+	// remove the view, if we have one
 	if ([area hasViewForParent:self]) {
 		CHChartAreaView *areaView = [area viewForParent:self];
-		[areaView removeFromSuperview];
+		NSMutableArray *shown = [_shownAreaViews[pageNum] mutableCopy];
+		[shown removeObject:areaView];
+		if (shown) {
+			_shownAreaViews[pageNum] = shown;
+		}
+		[CHChartAreaView enqueueReusableView:areaView];
 	}
 }
 
+/**
+ *  Moves a top-level area whose page was changed, e.g. in the inspector, to its new page in the index and takes its view along.
+ */
+- (void)areaPageDidChange:(NSNotification *)notification
+{
+	CHChartArea *area = notification.object;
+	if (area.chart != _chart || area.parent) {
+		return;
+	}
+	if (!_areasByPage) {
+		[self prepareAreaIndex];
+		return;
+	}
+	
+	NSNumber *oldNum = @([[self class] pageNumberForPage:[notification.userInfo[CHChartAreaOldPageKey] unsignedIntegerValue]]);
+	NSNumber *newNum = @([[self class] pageNumberForArea:area]);
+	if ([oldNum isEqualToNumber:newNum]) {
+		return;
+	}
+	
+	// update the index
+	NSMutableDictionary *index = [_areasByPage mutableCopy];
+	NSMutableArray *onOld = [index[oldNum] mutableCopy];
+	[onOld removeObject:area];
+	if (onOld) {
+		index[oldNum] = onOld;
+	}
+	NSArray *onNew = index[newNum];
+	index[newNum] = onNew ? [onNew arrayByAddingObject:area] : @[area];
+	self.areasByPage = index;
+	
+	// move the view; the active one follows to its new page, others are recreated once their page gets drawn
+	if ([area hasViewForParent:self]) {
+		CHChartAreaView *areaView = [area viewForParent:self];
+		NSMutableArray *shown = [_shownAreaViews[oldNum] mutableCopy];
+		[shown removeObject:areaView];
+		if (shown) {
+			_shownAreaViews[oldNum] = shown;
+		}
+		
+		BOOL pageExists = ([newNum unsignedIntegerValue] <= [self.document pageCount]);
+		if (pageExists && areaView == [self activeTopmostView]) {
+			NSArray *onNewPage = _shownAreaViews[newNum];
+			_shownAreaViews[newNum] = onNewPage ? [onNewPage arrayByAddingObject:areaView] : @[areaView];
+			[self goToPage:[self.document pageAtIndex:[newNum unsignedIntegerValue] - 1]];
+		}
+		else {
+			if (!pageExists) {
+				DLog(@"Area %@ moved to page %@, but the document only has %lu pages", area, newNum, (unsigned long)[self.document pageCount]);
+			}
+			if (areaView == [self activeTopmostView]) {
+				self.activeArea = nil;
+			}
+			[CHChartAreaView enqueueReusableView:areaView];
+		}
+	}
+	
+	[_positionedPageFrames removeObjectForKey:newNum];
+	[self setNeedsDisplay:YES];
+}
+
 
 
 #pragma mark - Mouse Handling
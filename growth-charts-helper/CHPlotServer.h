@@ -0,0 +1,54 @@
+/*
+ CHPlotServer.h
+ growth-charts-helper
+ 
+ Created by Pascal Pfiffner on 10/19/26.
+ Copyright (c) 2026 CHIP. All rights reserved.
+ 
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+ 
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#import <Foundation/Foundation.h>
+
+
+/**
+ *  A headless server answering chart requests over a Unix domain socket.
+ *
+ *  Keeps the chart catalog and the unit definitions in memory. Clients send one JSON object per line and get one JSON object per line back, carrying
+ *  the request's "id" and either a "result" or an "error". Supported "op"s are:
+ *  - "charts": the catalog, one summary per chart; charts are identified by their index in this list
+ *  - "select": charts for a "gender", plotting "dataType" and covering "age" ({"number": "24", "unit": "age.month"})
+ *  - "point": page coordinates of "value" at "age" for "dataType" on "chart", one per matching plot area; coordinates are relative to the page
+ *  - "convert": "number" from unit path "from" to unit path "to"
+ *  - "plausibility": whether "number" in "unit" is plausible (0), too low (-1) or too high (1)
+ *
+ *  Numbers can be JSON numbers or strings; fields of the wrong type get an error response. Lines longer than 1 MB close the connection.
+ *
+ *  Each chart's plot geometry is resolved once when the server is created. "point" requests arriving for the same chart while one is being handled
+ *  are batched. All requests are handled on the global concurrent queue.
+ */
+@interface CHPlotServer : NSObject
+
+@property (nonatomic, readonly, copy) NSString *socketPath;		///< Where we listen
+@property (nonatomic, readonly, copy) NSArray *charts;			///< The CHChart instances we serve
+
+- (instancetype)initWithSocketPath:(NSString *)socketPath charts:(NSArray *)charts;
+
+- (BOOL)start:(NSError **)error;
+- (void)stop;
+
+- (NSDictionary *)responseForRequest:(NSDictionary *)request;
+
+@end
@@ -0,0 +1,724 @@
+/*
+ CHPlotServer.m
+ growth-charts-helper
+ 
+ Created by Pascal Pfiffner on 10/19/26.
+ Copyright (c) 2026 CHIP. All rights reserved.
+ 
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+ 
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#import "CHPlotServer.h"
+#import "CHChart.h"
+#import "CHChartArea.h"
+#import "CHUnit.h"
+#import "PPRange.h"
+#import <sys/socket.h>
+#import <sys/un.h>
+#import <fcntl.h>
+
+
+#define CHPlotServerMaxLineLength (1024 * 1024)			///< Connections sending a longer line without newline are closed
+
+
+@class CHPlotServerConnection;
+
+
+/**
+ *  A plot area of a chart, resolved for fast lookups: the axes in doubles and the area's frame relative to the page.
+ */
+@interface CHPlotServerPlot : NSObject
+
+@property (nonatomic, assign) NSUInteger page;
+@property (nonatomic, assign) CGRect pageFrame;				///< The plot area's frame relative to its page
+@property (nonatomic, assign) BOOL ageOnX;
+@property (nonatomic, copy) NSString *dataType;				///< The data type plotted against age
+@property (nonatomic, strong) CHUnit *ageUnit;
+@property (nonatomic, strong) CHUnit *valueUnit;
+@property (nonatomic, assign) double ageFrom;
+@property (nonatomic, assign) double ageTo;
+@property (nonatomic, assign) double valueFrom;
+@property (nonatomic, assign) double valueTo;
+
+@end
+
+
+/**
+ *  One client connection, reading and writing newline delimited JSON.
+ */
+@interface CHPlotServerConnection : NSObject
+
+@property (nonatomic, weak) CHPlotServer *server;
+@property (nonatomic, strong) dispatch_queue_t queue;
+@property (nonatomic, strong) dispatch_io_t channel;
+@property (nonatomic, strong) NSMutableData *buffer;
+
+- (instancetype)initWithFileDescriptor:(int)fd server:(CHPlotServer *)server;
+- (void)sendResponse:(NSDictionary *)response;
+- (void)close;
+
+@end
+
+
+@interface CHPlotServer ()
+
+@property (nonatomic, readwrite, copy) NSString *socketPath;
+@property (nonatomic, readwrite, copy) NSArray *charts;
+@property (nonatomic, copy) NSArray *plotsByChart;					///< One array of CHPlotServerPlot per chart, in the order of "charts"
+
+@property (nonatomic, strong) dispatch_source_t listenSource;
+@property (nonatomic, strong) dispatch_queue_t batchQueue;			///< Serial, guards "pendingByChart"
+@property (nonatomic, strong) NSMutableDictionary *pendingByChart;	///< Chart index -> array of @[request, connection] waiting for their batch
+@property (nonatomic, strong) NSMutableSet *connections;
+@property (nonatomic, strong) NSMutableDictionary *units;			///< Unit path -> CHUnit (or NSNull for unknown paths), guarded by itself
+
+- (void)handleRequest:(NSDictionary *)request fromConnection:(CHPlotServerConnection *)connection;
+- (void)connectionDidClose:(CHPlotServerConnection *)connection;
+
+@end
+
+
+@implementation CHPlotServer
+
+
+- (instancetype)initWithSocketPath:(NSString *)socketPath charts:(NSArray *)charts
+{
+	if ((self = [super init])) {
+		self.socketPath = socketPath;
+		self.charts = charts;
+		self.batchQueue = dispatch_queue_create("org.chip.growth-charts.plot-server.batches", DISPATCH_QUEUE_SERIAL);
+		self.pendingByChart = [NSMutableDictionary new];
+		self.connections = [NSMutableSet new];
+		self.units = [NSMutableDictionary new];
+		
+		// the age range is cached lazily and the plots never change, resolve both now while we're still on one thread
+		NSMutableArray *plots = [NSMutableArray arrayWithCapacity:[_charts count]];
+		for (CHChart *chart in _charts) {
+			[chart ageRangeMonths];
+			[plots addObject:[self plotsOfChart:chart]];
+		}
+		self.plotsByChart = plots;
+	}
+	return self;
+}
+
+- (void)dealloc
+{
+	[self stop];
+}
+
+
+
+#pragma mark - Listening
+/**
+ *  Binds the socket and starts accepting connections; a stale socket file at our path is removed first.
+ */
+- (BOOL)start:(NSError **)error
+{
+	if (_listenSource) {
+		return YES;
+	}
+	
+	struct sockaddr_un addr;
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	const char *path = [_socketPath fileSystemRepresentation];
+	if (!path || strlen(path) >= sizeof(addr.sun_path)) {
+		if (error) {
+			*error = [NSError errorWithDomain:NSPOSIXErrorDomain code:ENAMETOOLONG userInfo:@{NSLocalizedDescriptionKey: @"Socket path is too long"}];
+		}
+		return NO;
+	}
+	strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+	
+	int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (fd < 0) {
+		if (error) {
+			*error = [NSError errorWithDomain:NSPOSIXErrorDomain code:errno userInfo:nil];
+		}
+		return NO;
+	}
+	
+	unlink(path);
+	if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(fd, SOMAXCONN) < 0 || fcntl(fd, F_SETFL, O_NONBLOCK) < 0) {
+		if (error) {
+			*error = [NSError errorWithDomain:NSPOSIXErrorDomain code:errno userInfo:nil];
+		}
+		close(fd);
+		return NO;
+	}
+	
+	__weak CHPlotServer *this = self;
+	self.listenSource = dispatch_source_create(DISPATCH_SOURCE_TYPE_READ, fd, 0, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0));
+	dispatch_source_set_event_handler(_listenSource, ^{
+		[this acceptConnectionsOn:fd];
+	});
+	dispatch_source_set_cancel_handler(_listenSource, ^{
+		close(fd);
+	});
+	dispatch_resume(_listenSource);
+	
+	DLog(@"Serving %lu charts on %@", (unsigned long)[_charts count], _socketPath);
+	return YES;
+}
+
+/**
+ *  Stops accepting connections, closes open ones and removes the socket file.
+ */
+- (void)stop
+{
+	if (!_listenSource) {
+		return;
+	}
+	
+	dispatch_source_cancel(_listenSource);
+	self.listenSource = nil;
+	unlink([_socketPath fileSystemRepresentation]);
+	
+	NSSet *open = nil;
+	@synchronized(_connections) {
+		open = [_connections copy];
+	}
+	[open makeObjectsPerformSelector:@selector(close)];
+}
+
+- (void)acceptConnectionsOn:(int)listenFD
+{
+	while (YES) {
+		int fd = accept(listenFD, NULL, NULL);
+		if (fd < 0) {
+			if (EAGAIN != errno && EWOULDBLOCK != errno && EINTR != errno) {
+				DLog(@"Failed to accept a connection: %s", strerror(errno));
+			}
+			return;
+		}
+		
+		int noSigPipe = 1;
+		setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &noSigPipe, sizeof(noSigPipe));
+		
+		CHPlotServerConnection *connection = [[CHPlotServerConnection alloc] initWithFileDescriptor:fd server:self];
+		@synchronized(_connections) {
+			[_connections addObject:connection];
+		}
+	}
+}
+
+- (void)connectionDidClose:(CHPlotServerConnection *)connection
+{
+	@synchronized(_connections) {
+		[_connections removeObject:connection];
+	}
+}
+
+
+
+#pragma mark - Dispatching
+/**
+ *  Point requests are batched per chart, everything else is handled right away on the worker pool.
+ */
+- (void)handleRequest:(NSDictionary *)request fromConnection:(CHPlotServerConnection *)connection
+{
+	if ([@"point" isEqualToString:request[@"op"]]) {
+		NSInteger index = [self chartIndexForRequest:request];
+		if (NSNotFound != index) {
+			[self enqueueRequest:request fromConnection:connection forChart:index];
+			return;
+		}
+	}
+	
+	dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+		[connection sendResponse:[self responseForRequest:request]];
+	});
+}
+
+- (void)enqueueRequest:(NSDictionary *)request fromConnection:(CHPlotServerConnection *)connection forChart:(NSInteger)index
+{
+	dispatch_async(_batchQueue, ^{
+		NSNumber *key = @(index);
+		NSMutableArray *pending = _pendingByChart[key];
+		if (pending) {
+			[pending addObject:@[request, connection]];			// a batch is already scheduled and will pick this up
+			return;
+		}
+		
+		_pendingByChart[key] = [NSMutableArray arrayWithObject:@[request, connection]];
+		dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+			[self runBatchForChart:index];
+		});
+	});
+}
+
+/**
+ *  Takes all requests pending for the chart and answers them. A request raising an exception only fails itself, not the rest of the batch.
+ */
+- (void)runBatchForChart:(NSInteger)index
+{
+	__block NSArray *batch = nil;
+	dispatch_sync(_batchQueue, ^{
+		NSNumber *key = @(index);
+		batch = _pendingByChart[key];
+		[_pendingByChart removeObjectForKey:key];
+	});
+	
+	NSArray *plots = _plotsByChart[index];
+	for (NSArray *item in batch) {
+		NSDictionary *request = item[0];
+		CHPlotServerConnection *connection = item[1];
+		id result = nil;
+		@try {
+			result = [self pointsForRequest:request inPlots:plots];
+		}
+		@catch (NSException *exception) {
+			DLog(@"Exception answering %@: %@", request, exception);
+			result = [self errorWithMessage:[NSString stringWithFormat:@"Failed: %@", [exception reason]]];
+		}
+		[connection sendResponse:[self respondTo:request withResult:result]];
+	}
+}
+
+
+
+#pragma mark - Requests
+/**
+ *  Answers a request synchronously. This is what the socket clients get, minus the batching. Exceptions are caught and turned into an error response,
+ *  so a bad request can't take the server down.
+ */
+- (NSDictionary *)responseForRequest:(NSDictionary *)request
+{
+	if (![request isKindOfClass:[NSDictionary class]]) {
+		return @{@"id": [NSNull null], @"error": @"Requests must be JSON objects"};
+	}
+	
+	id result = nil;
+	@try {
+		result = [self resultForRequest:request];
+	}
+	@catch (NSException *exception) {
+		DLog(@"Exception answering %@: %@", request, exception);
+		result = [self errorWithMessage:[NSString stringWithFormat:@"Failed: %@", [exception reason]]];
+	}
+	
+	return [self respondTo:request withResult:result];
+}
+
+- (id)resultForRequest:(NSDictionary *)request
+{
+	NSString *op = request[@"op"];
+	if (![op isKindOfClass:[NSString class]]) {
+		return [self errorWithMessage:@"\"op\" must be a string"];
+	}
+	
+	id result = nil;
+	if ([@"charts" isEqualToString:op]) {
+		result = [self chartSummaries];
+	}
+	else if ([@"select" isEqualToString:op]) {
+		result = [self selectCharts:request];
+	}
+	else if ([@"point" isEqualToString:op]) {
+		NSInteger index = [self chartIndexForRequest:request];
+		result = (NSNotFound != index) ? [self pointsForRequest:request inPlots:_plotsByChart[index]] : [self errorWithMessage:@"Unknown chart"];
+	}
+	else if ([@"convert" isEqualToString:op]) {
+		result = [self convert:request];
+	}
+	else if ([@"plausibility" isEqualToString:op]) {
+		result = [self plausibility:request];
+	}
+	else {
+		result = [self errorWithMessage:[NSString stringWithFormat:@"Unknown op \"%@\"", op]];
+	}
+	return result;
+}
+
+- (NSDictionary *)respondTo:(NSDictionary *)request withResult:(id)result
+{
+	NSMutableDictionary *response = [NSMutableDictionary dictionaryWithCapacity:2];
+	id requestID = [request isKindOfClass:[NSDictionary class]] ? request[@"id"] : nil;
+	response[@"id"] = requestID ? requestID : [NSNull null];
+	if ([result isKindOfClass:[NSError class]]) {
+		response[@"error"] = [(NSError *)result localizedDescription];
+	}
+	else {
+		response[@"result"] = result ? result : [NSNull null];
+	}
+	return response;
+}
+
+- (NSError *)errorWithMessage:(NSString *)message
+{
+	return [NSError errorWithDomain:@"CHPlotServerErrorDomain" code:0 userInfo:@{NSLocalizedDescriptionKey: message}];
+}
+
+- (NSArray *)chartSummaries
+{
+	NSMutableArray *summaries = [NSMutableArray arrayWithCapacity:[_charts count]];
+	NSUInteger i = 0;
+	for (CHChart *chart in _charts) {
+		PPRange *ages = chart.ageRangeMonths;
+		[summaries addObject:@{
+			@"chart": @(i++),
+			@"name": chart.name ? chart.name : @"",
+			@"source": chart.sourceAcronym ? chart.sourceAcronym : @"",
+			@"gender": @(chart.gender),
+			@"dataTypes": [[chart plotDataTypes] allObjects],
+			@"ageMonths": @[(ages.from ? [ages.from stringValue] : [NSNull null]), (ages.to ? [ages.to stringValue] : [NSNull null])]
+		}];
+	}
+	return summaries;
+}
+
+- (id)selectCharts:(NSDictionary *)request
+{
+	id genderNumber = request[@"gender"];
+	NSString *dataType = request[@"dataType"];
+	if ((genderNumber && ![genderNumber isKindOfClass:[NSNumber class]]) || (dataType && ![dataType isKindOfClass:[NSString class]])) {
+		return [self errorWithMessage:@"\"gender\" must be a number and \"dataType\" a string"];
+	}
+	
+	CHGender gender = [genderNumber intValue];
+	CHDecimal ageMonths = CHDecimalMakeUndefined();
+	if (request[@"age"]) {
+		ageMonths = [self decimalFrom:request[@"age"] inUnit:[self unitForPath:@"age.month"]];
+		if (!CHDecimalIsNumber(ageMonths)) {
+			return [self errorWithMessage:@"Invalid \"age\""];
+		}
+	}
+	
+	NSMutableArray *selected = [NSMutableArray array];
+	NSUInteger i = 0;
+	for (CHChart *chart in _charts) {
+		BOOL genderOK = (CHGenderUnknown == gender || CHGenderUnknown == chart.gender || gender == chart.gender);
+		BOOL dataTypeOK = (!dataType || [chart plotsAreaWithDataType:dataType]);
+		BOOL ageOK = (!CHDecimalIsDefined(ageMonths) || PPRangeResultOK == [chart.ageRangeMonths testDecimal:ageMonths]);
+		if (genderOK && dataTypeOK && ageOK) {
+			[selected addObject:@(i)];
+		}
+		i++;
+	}
+	return selected;
+}
+
+- (id)pointsForRequest:(NSDictionary *)request inPlots:(NSArray *)plots
+{
+	NSString *dataType = request[@"dataType"];
+	NSDictionary *age = request[@"age"];
+	NSDictionary *value = request[@"value"];
+	if (![dataType isKindOfClass:[NSString class]] || ![age isKindOfClass:[NSDictionary class]] || ![value isKindOfClass:[NSDictionary class]]) {
+		return [self errorWithMessage:@"\"point\" needs \"dataType\", \"age\" and \"value\""];
+	}
+	
+	NSMutableArray *points = [NSMutableArray array];
+	for (CHPlotServerPlot *plot in plots) {
+		if (![dataType isEqualToString:plot.dataType]) {
+			continue;
+		}
+		
+		double ageValue = CHDecimalDoubleValue([self decimalFrom:age inUnit:plot.ageUnit]);
+		double valueValue = CHDecimalDoubleValue([self decimalFrom:value inUnit:plot.valueUnit]);
+		if (!isfinite(ageValue) || !isfinite(valueValue)) {
+			continue;
+		}
+		
+		double a = (ageValue - plot.ageFrom) / (plot.ageTo - plot.ageFrom);
+		double v = (valueValue - plot.valueFrom) / (plot.valueTo - plot.valueFrom);
+		double x = plot.ageOnX ? a : v;
+		double y = plot.ageOnX ? v : a;
+		
+		CGRect frame = plot.pageFrame;
+		[points addObject:@{
+			@"page": @(plot.page),
+			@"x": @(frame.origin.x + x * frame.size.width),
+			@"y": @(frame.origin.y + y * frame.size.height),
+			@"inside": @(x >= 0.0 && x <= 1.0 && y >= 0.0 && y <= 1.0)
+		}];
+	}
+	return points;
+}
+
+- (id)convert:(NSDictionary *)request
+{
+	CHUnit *from = [self unitForPath:request[@"from"]];
+	CHUnit *to = [self unitForPath:request[@"to"]];
+	if (!from || !to) {
+		return [self errorWithMessage:@"Unknown unit"];
+	}
+	
+	CHDecimal number = [self decimalFromNumber:request[@"number"]];
+	if (!CHDecimalIsNumber(number)) {
+		return [self errorWithMessage:@"Invalid \"number\""];
+	}
+	
+	CHDecimal converted = [from convertDecimal:number toUnit:to];
+	if (!CHDecimalIsNumber(converted)) {
+		return [self errorWithMessage:@"Cannot convert"];
+	}
+	return CHDecimalString(converted);
+}
+
+- (id)plausibility:(NSDictionary *)request
+{
+	CHUnit *unit = [self unitForPath:request[@"unit"]];
+	if (!unit) {
+		return [self errorWithMessage:@"Unknown unit"];
+	}
+	
+	CHDecimal number = [self decimalFromNumber:request[@"number"]];
+	if (!CHDecimalIsNumber(number)) {
+		return [self errorWithMessage:@"Invalid \"number\""];
+	}
+	return @([unit checkPlausibilityOfDecimal:number]);
+}
+
+
+
+#pragma mark - Utilities
+/**
+ *  @return The chart index given in "chart", NSNotFound if it's missing or out of range
+ */
+- (NSInteger)chartIndexForRequest:(NSDictionary *)request
+{
+	id chart = [request isKindOfClass:[NSDictionary class]] ? request[@"chart"] : nil;
+	if (![chart isKindOfClass:[NSNumber class]] || [chart integerValue] < 0 || [chart unsignedIntegerValue] >= [_charts count]) {
+		return NSNotFound;
+	}
+	return [chart integerValue];
+}
+
+/**
+ *  Units are immutable once created, so we create each only once and share them between all requests.
+ */
+- (CHUnit *)unitForPath:(NSString *)path
+{
+	if (![path isKindOfClass:[NSString class]]) {
+		return nil;
+	}
+	
+	@synchronized(_units) {
+		id unit = _units[path];
+		if (!unit) {
+			unit = [CHUnit isKnownUnitPath:path] ? [CHUnit newWithPath:path] : nil;
+			_units[path] = unit ? unit : [NSNull null];
+		}
+		return [unit isKindOfClass:[CHUnit class]] ? unit : nil;
+	}
+}
+
+/**
+ *  Numbers can be sent as JSON numbers or as strings, the latter keep all their digits.
+ *  @return The number, undefined if it's neither a string nor a number
+ */
+- (CHDecimal)decimalFromNumber:(id)number
+{
+	if (![number isKindOfClass:[NSString class]] && ![number isKindOfClass:[NSNumber class]]) {
+		return CHDecimalMakeUndefined();
+	}
+	return CHDecimalFromString([number description]);
+}
+
+/**
+ *  Reads a {"number": "12.5", "unit": "length.centimeter"} dictionary and converts the number to the given unit. Without unit the number is taken to be
+ *  in the given unit already.
+ *  @return The converted number, undefined if the number is missing or if the unit is given but unknown
+ */
+- (CHDecimal)decimalFrom:(NSDictionary *)dict inUnit:(CHUnit *)targetUnit
+{
+	if (![dict isKindOfClass:[NSDictionary class]]) {
+		return CHDecimalMakeUndefined();
+	}
+	
+	CHDecimal number = [self decimalFromNumber:dict[@"number"]];
+	id unitPath = dict[@"unit"];
+	if (!unitPath) {
+		return number;
+	}
+	CHUnit *unit = [self unitForPath:unitPath];
+	return unit ? [unit convertDecimal:number toUnit:targetUnit] : CHDecimalMakeUndefined();
+}
+
+/**
+ *  Resolves all plot areas of the chart that plot something against age.
+ */
+- (NSArray *)plotsOfChart:(CHChart *)chart
+{
+	NSMutableArray *plots = [NSMutableArray array];
+	[self collectPlotsOfAreas:[chart.chartAreas allObjects] into:plots];
+	return plots;
+}
+
+- (void)collectPlotsOfAreas:(NSArray *)areas into:(NSMutableArray *)plots
+{
+	for (CHChartArea *area in areas) {
+		[self collectPlotsOfAreas:area.areas into:plots];
+		if (![@"plot" isEqualToString:area.type]) {
+			continue;
+		}
+		
+		BOOL ageOnX = [@"age" isEqualToString:area.xAxisDataType];
+		if (!ageOnX && ![@"age" isEqualToString:area.yAxisDataType]) {
+			continue;
+		}
+		
+		CHPlotServerPlot *plot = [CHPlotServerPlot new];
+		plot.ageOnX = ageOnX;
+		plot.dataType = ageOnX ? area.yAxisDataType : area.xAxisDataType;
+		plot.ageUnit = [self unitForPath:(ageOnX ? area.xAxisUnitName : area.yAxisUnitName)];
+		plot.valueUnit = [self unitForPath:(ageOnX ? area.yAxisUnitName : area.xAxisUnitName)];
+		plot.ageFrom = CHDecimalDoubleValue(ageOnX ? area.xAxisFromDecimal : area.yAxisFromDecimal);
+		plot.ageTo = CHDecimalDoubleValue(ageOnX ? area.xAxisToDecimal : area.yAxisToDecimal);
+		plot.valueFrom = CHDecimalDoubleValue(ageOnX ? area.yAxisFromDecimal : area.xAxisFromDecimal);
+		plot.valueTo = CHDecimalDoubleValue(ageOnX ? area.yAxisToDecimal : area.xAxisToDecimal);
+		if (!plot.ageUnit || !plot.valueUnit || plot.ageFrom == plot.ageTo || plot.valueFrom == plot.valueTo) {
+			DLog(@"Skipping plot area with unusable axes: %@", area);
+			continue;
+		}
+		
+		// walk up to the page, frames are relative to the parent
+		CGRect frame = area.frame;
+		CHChartArea *top = area;
+		for (CHChartArea *parent = area.parent; parent; parent = parent.parent) {
+			CGRect parentFrame = parent.frame;
+			frame.origin.x = parentFrame.origin.x + frame.origin.x * parentFrame.size.width;
+			frame.origin.y = parentFrame.origin.y + frame.origin.y * parentFrame.size.height;
+			frame.size.width *= parentFrame.size.width;
+			frame.size.height *= parentFrame.size.height;
+			top = parent;
+		}
+		plot.pageFrame = frame;
+		plot.page = (0 == top.page || NSNotFound == top.page) ? 1 : top.page;
+		
+		[plots addObject:plot];
+	}
+}
+
+
+@end
+
+
+
+@implementation CHPlotServerPlot
+@end
+
+
+
+@implementation CHPlotServerConnection
+
+
+- (instancetype)initWithFileDescriptor:(int)fd server:(CHPlotServer *)server
+{
+	if ((self = [super init])) {
+		self.server = server;
+		self.buffer = [NSMutableData new];
+		self.queue = dispatch_queue_create("org.chip.growth-charts.plot-server.connection", DISPATCH_QUEUE_SERIAL);
+		self.channel = dispatch_io_create(DISPATCH_IO_STREAM, fd, _queue, ^(int error) {
+			close(fd);
+		});
+		dispatch_io_set_low_water(_channel, 1);
+		
+		// we keep a strong reference to ourselves in the handler until the client hangs up
+		dispatch_io_read(_channel, 0, SIZE_MAX, _queue, ^(bool done, dispatch_data_t data, int error) {
+			if (data) {
+				[self didReceiveData:data];
+			}
+			if (done) {
+				[self close];
+			}
+		});
+	}
+	return self;
+}
+
+/**
+ *  Collects incoming bytes and hands every complete line to the server.
+ */
+- (void)didReceiveData:(dispatch_data_t)data
+{
+	dispatch_data_apply(data, ^bool(dispatch_data_t region, size_t offset, const void *bytes, size_t size) {
+		[_buffer appendBytes:bytes length:size];
+		return true;
+	});
+	
+	const char *bytes = [_buffer bytes];
+	NSUInteger length = [_buffer length];
+	NSUInteger lineStart = 0;
+	for (NSUInteger i = 0; i < length; i++) {
+		if ('\n' != bytes[i]) {
+			continue;
+		}
+		if (i > lineStart) {
+			NSData *line = [NSData dataWithBytesNoCopy:(void *)(bytes + lineStart) length:(i - lineStart) freeWhenDone:NO];
+			NSError *error = nil;
+			id request = [NSJSONSerialization JSONObjectWithData:line options:0 error:&error];
+			if ([request isKindOfClass:[NSDictionary class]]) {
+				[_server handleRequest:request fromConnection:self];
+			}
+			else {
+				[self sendResponse:@{@"id": [NSNull null], @"error": @"Requests must be JSON objects, one per line"}];
+			}
+		}
+		lineStart = i + 1;
+	}
+	
+	if (lineStart > 0) {
+		[_buffer replaceBytesInRange:NSMakeRange(0, lineStart) withBytes:NULL length:0];
+	}
+	
+	// don't buffer forever for a client that never sends a newline
+	if ([_buffer length] > CHPlotServerMaxLineLength) {
+		DLog(@"Closing connection, line longer than %d bytes", CHPlotServerMaxLineLength);
+		[self sendResponse:@{@"id": [NSNull null], @"error": @"Request too long"}];
+		[_buffer setLength:0];
+		[self close];
+	}
+}
+
+- (void)sendResponse:(NSDictionary *)response
+{
+	NSMutableData *json = [[NSJSONSerialization dataWithJSONObject:response options:0 error:nil] mutableCopy];
+	if (!json) {
+		json = [[@"{\"id\":null,\"error\":\"Failed to serialize the response\"}" dataUsingEncoding:NSUTF8StringEncoding] mutableCopy];
+	}
+	[json appendBytes:"\n" length:1];
+	
+	dispatch_data_t data = dispatch_data_create([json bytes], [json length], _queue, DISPATCH_DATA_DESTRUCTOR_DEFAULT);
+	dispatch_async(_queue, ^{
+		if (!_channel) {
+			return;
+		}
+		dispatch_io_write(_channel, 0, data, _queue, ^(bool done, dispatch_data_t remaining, int error) {
+			if (error) {
+				DLog(@"Failed to write a response: %s", strerror(error));
+			}
+		});
+	});
+}
+
+/**
+ *  Closes the channel on our queue, so it's safe to call from any thread.
+ */
+- (void)close
+{
+	dispatch_async(_queue, ^{
+		if (_channel) {
+			dispatch_io_close(_channel, DISPATCH_IO_STOP);
+			self.channel = nil;
+			[_server connectionDidClose:self];
+		}
+	});
+}
+
+
+@end
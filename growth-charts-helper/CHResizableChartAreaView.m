@@ -21,11 +21,13 @@
  */
 
 #import "CHResizableChartAreaView.h"
+#import "CHChartArea.h"
 
 
 @interface CHResizableChartAreaView () {
 	NSPoint dragStartPoint;
 	NSInteger mouseActionEffect;				// 0 = drag, 1 and -1 = resize width, 2 and -2 = resize height
+	BOOL inDragTransaction;						// YES between mouseDown and mouseUp, while the area's frame changes are collected
 }
 
 @property (nonatomic, strong) NSTrackingArea *tracker;
@@ -46,18 +48,46 @@
 
 
 
+/**
+ *  Forget about an ongoing mouse action when being reused.
+ */
+- (void)prepareForReuse
+{
+	[self commitDragTransaction];
+	[super prepareForReuse];
+	dragStartPoint = NSZeroPoint;
+	mouseActionEffect = 0;
+}
+
+/**
+ *  A drag can't end with mouse up once we leave the window, so close its transaction now; the old window's undo manager still gets the undo.
+ */
+- (void)viewWillMoveToWindow:(NSWindow *)newWindow
+{
+	if (newWindow != self.window) {
+		[self commitDragTransaction];
+	}
+	[super viewWillMoveToWindow:newWindow];
+}
+
+
+
 #pragma mark - Tracking Areas
+/**
+ *  The tracker follows our visible rect, so it is only created once and survives resizing as well as reuse of the view.
+ */
 - (void)updateTrackingAreas
 {
+	[super updateTrackingAreas];
+	
 	// full size tracker
-	if (_tracker) {
-		[self removeTrackingArea:_tracker];
+	if (!_tracker) {
+		self.tracker = [[NSTrackingArea alloc] initWithRect:NSZeroRect
+													options:(NSTrackingMouseEnteredAndExited | NSTrackingMouseMoved | NSTrackingActiveInKeyWindow | NSTrackingInVisibleRect)		// NSTrackingCursorUpdate
+													  owner:self
+												   userInfo:nil];
+		[self addTrackingArea:_tracker];
 	}
-	self.tracker = [[NSTrackingArea alloc] initWithRect:self.bounds
-												options:(NSTrackingMouseEnteredAndExited | NSTrackingMouseMoved | NSTrackingActiveInKeyWindow)		// NSTrackingCursorUpdate
-												  owner:self
-											   userInfo:nil];
-	[self addTrackingArea:_tracker];
 }
 
 - (void)cursorUpdateDOESNOTWORKLIKEIWANTITTOWORK:(NSEvent *)theEvent
@@ -95,32 +125,56 @@
 	[self interpretKeyEvents:@[theEvent]];
 }
 
--(void)moveUp:(id)sender
+- (void)moveUp:(id)sender
 {
 	CGRect frame = self.frame;
 	frame.origin.y += 1.f;
-	self.frame = frame;
+	[self moveToFrame:frame];
 }
 
 - (void)moveLeft:(id)sender
 {
 	CGRect frame = self.frame;
 	frame.origin.x -= 1.f;
-	self.frame = frame;
+	[self moveToFrame:frame];
 }
 
 - (void)moveRight:(id)sender
 {
 	CGRect frame = self.frame;
 	frame.origin.x += 1.f;
-	self.frame = frame;
+	[self moveToFrame:frame];
 }
 
 - (void)moveDown:(id)sender
 {
 	CGRect frame = self.frame;
 	frame.origin.y -= 1.f;
+	[self moveToFrame:frame];
+}
+
+/**
+ *  Escape cancels an ongoing drag, putting the area back where it was.
+ */
+- (void)cancelOperation:(id)sender
+{
+	if (inDragTransaction) {
+		inDragTransaction = NO;
+		dragStartPoint = NSZeroPoint;
+		[CHChartArea rollbackTransaction];
+	}
+}
+
+
+
+/**
+ *  Sets the frame in a transaction so that the move can be undone.
+ */
+- (void)moveToFrame:(CGRect)frame
+{
+	[CHChartArea beginTransaction];
 	self.frame = frame;
+	[CHChartArea commitTransactionWithUndoManager:self.window.undoManager actionName:@"Move Area"];
 }
 
 
@@ -177,6 +231,11 @@
 	if (self.active) {
 		dragStartPoint = [theEvent locationInWindow];
 		[[NSCursor closedHandCursor] push];
+		
+		// collect all frame changes of the drag, they are applied (and undoable) on mouse up; close a drag whose mouse up we never got
+		[self commitDragTransaction];
+		inDragTransaction = YES;
+		[CHChartArea beginTransaction];
 	}
 }
 
@@ -184,6 +243,12 @@
 {
 	[super mouseDragged:theEvent];
 	
+	// the drag was cancelled or its mouse up went elsewhere
+	if (!inDragTransaction || 0 == ([NSEvent pressedMouseButtons] & 1)) {
+		[self commitDragTransaction];
+		return;
+	}
+	
 	// mouse drags
 	if (self.active) {
 		NSPoint currentPoint = [theEvent locationInWindow];
@@ -226,6 +291,16 @@
 		dragStartPoint = NSZeroPoint;
 		[NSCursor pop];
 	}
+	[self commitDragTransaction];
+}
+
+- (void)commitDragTransaction
+{
+	if (inDragTransaction) {
+		inDragTransaction = NO;
+		NSString *action = (0 == mouseActionEffect) ? @"Move Area" : @"Resize Area";
+		[CHChartArea commitTransactionWithUndoManager:self.window.undoManager actionName:action];
+	}
 }
 
 - (void)mouseExited:(NSEvent *)theEvent
@@ -49,6 +49,7 @@
 
 - (void)dealloc
 {
+	[[NSNotificationCenter defaultCenter] removeObserver:self];
 	self.activeArea = nil;
 	self.pdf = nil;
 }
@@ -69,6 +70,16 @@
 	
 	// register for notifications
 	[[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(didDropFiles:) name:CHDropViewDroppedItemsNotificationName object:nil];
+	[[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(windowWillClose:) name:NSWindowWillCloseNotification object:[self window]];
+}
+
+/**
+ *  Gives the area views back and empties the reuse pool, so a closed chart doesn't keep its views alive.
+ */
+- (void)windowWillClose:(NSNotification *)notification
+{
+	_pdf.chart = nil;
+	[CHChartAreaView drainReusePool];
 }
 
 - (NSUndoManager *)undoManager
@@ -99,6 +110,7 @@
 	if (pdf != _pdf) {
 		if (_pdf) {
 			[_pdf removeObserver:self forKeyPath:@"activeArea"];
+			_pdf.chart = nil;				// puts the area views back into the reuse pool
 			[_pdf removeFromSuperview];
 		}
 		
@@ -79,4 +79,6 @@
 - (BOOL)hasAreaWithDataType:(NSString *)dataType;
 - (BOOL)plotsAreaWithDataType:(NSString *)dataType;
 
+- (NSUInteger)estimatedMemoryFootprint;
+
 @end
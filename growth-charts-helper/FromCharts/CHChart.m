@@ -11,7 +11,7 @@
 #import "CHValue.h"
 #import "CHUnit.h"
 #import "PPRange.h"
-#import "NSDecimalNumber+Extension.h"
+#import <objc/runtime.h>
 
 
 @interface CHChart ()
@@ -99,9 +99,9 @@
 			PPRange *range1 = chart1.ageRangeMonths;
 			PPRange *range2 = chart2.ageRangeMonths;
 			
-			NSComparisonResult lower = [range1.from compare:range2.from];
+			NSComparisonResult lower = CHDecimalCompare(range1.fromDecimal, range2.fromDecimal);
 			if (NSOrderedSame == lower) {
-				return [range1.to compare:range2.to];
+				return CHDecimalCompare(range1.toDecimal, range2.toDecimal);
 			}
 			return lower;
 		}];
@@ -331,8 +331,8 @@
 - (PPRange *)ageRangeMonths
 {
 	if (!_ageRangeMonths) {
-		NSDecimalNumber *min = nil;
-		NSDecimalNumber *max = nil;
+		CHDecimal min = CHDecimalMakeUndefined();
+		CHDecimal max = CHDecimalMakeUndefined();
 		CHUnit *month = [CHUnit newWithPath:@"age.month"];
 		
 		// find plot areas
@@ -342,14 +342,14 @@
 				// x axis
 				if ([@"age" isEqualToString:area.xAxisDataType]) {
 					CHUnit *xUnit = [CHUnit newWithPath:area.xAxisUnitName];
-					NSDecimalNumber *xMin = [xUnit convertNumber:[area.xAxisFrom smallerNumber:area.xAxisTo] toUnit:month];
-					NSDecimalNumber *xMax = [xUnit convertNumber:[area.xAxisFrom greaterNumber:area.xAxisTo] toUnit:month];
+					CHDecimal xMin = [xUnit convertDecimal:CHDecimalSmaller(area.xAxisFromDecimal, area.xAxisToDecimal) toUnit:month];
+					CHDecimal xMax = [xUnit convertDecimal:CHDecimalGreater(area.xAxisFromDecimal, area.xAxisToDecimal) toUnit:month];
 					
-					if (!min || NSOrderedAscending == [xMin compare:min]) {
+					if (CHDecimalIsDefined(xMin) && (!CHDecimalIsDefined(min) || NSOrderedAscending == CHDecimalCompare(xMin, min))) {
 						min = xMin;
 					}
 					
-					if (!max || NSOrderedDescending == [xMax compare:max]) {
+					if (CHDecimalIsDefined(xMax) && (!CHDecimalIsDefined(max) || NSOrderedDescending == CHDecimalCompare(xMax, max))) {
 						max = xMax;
 					}
 				}
@@ -357,27 +357,42 @@
 				// y axis
 				if ([@"age" isEqualToString:area.yAxisDataType]) {
 					CHUnit *yUnit = [CHUnit newWithPath:area.yAxisUnitName];
-					NSDecimalNumber *yMin = [yUnit convertNumber:[area.yAxisFrom smallerNumber:area.yAxisTo] toUnit:month];
-					NSDecimalNumber *yMax = [yUnit convertNumber:[area.yAxisFrom greaterNumber:area.yAxisTo] toUnit:month];
+					CHDecimal yMin = [yUnit convertDecimal:CHDecimalSmaller(area.yAxisFromDecimal, area.yAxisToDecimal) toUnit:month];
+					CHDecimal yMax = [yUnit convertDecimal:CHDecimalGreater(area.yAxisFromDecimal, area.yAxisToDecimal) toUnit:month];
 					
-					if (!min || NSOrderedAscending == [yMin compare:min]) {
+					if (CHDecimalIsDefined(yMin) && (!CHDecimalIsDefined(min) || NSOrderedAscending == CHDecimalCompare(yMin, min))) {
 						min = yMin;
 					}
 					
-					if (!max || NSOrderedDescending == [yMax compare:max]) {
+					if (CHDecimalIsDefined(yMax) && (!CHDecimalIsDefined(max) || NSOrderedDescending == CHDecimalCompare(yMax, max))) {
 						max = yMax;
 					}
 				}
 			}
 		}
 		
-		self.ageRangeMonths = [PPRange rangeFrom:min to:max];
+		self.ageRangeMonths = [PPRange rangeFromDecimal:min toDecimal:max];
 	}
 	return _ageRangeMonths;
 }
 
 
 
+#pragma mark - Memory
+/**
+ *  A rough estimate of how many bytes the receiver and all its areas occupy, not counting the PDF document and strings shared between charts.
+ */
+- (NSUInteger)estimatedMemoryFootprint
+{
+	NSUInteger bytes = class_getInstanceSize([self class]);
+	bytes += [_name length] + [_sourceName length] + [_sourceAcronym length] + [_shortDescription length] + [_source length];
+	for (CHChartArea *area in _chartAreas) {
+		bytes += [area estimatedMemoryFootprint];
+	}
+	
+	return bytes;
+}
+
 #pragma mark - Utilities
 - (NSString *)description
 {
@@ -22,10 +22,17 @@
 
 #import <Foundation/Foundation.h>
 #import "CHChart.h"
+#import "CHStatsSource.h"
 #import "CHJSONHandling.h"
+#import "CHDecimal.h"
 
 @class CHChartAreaView;
 
+extern NSString *const CHChartAreaTransactionDidCommitNotification;
+extern NSString *const CHChartAreaTransactionChangedAreasKey;
+extern NSString *const CHChartAreaPageDidChangeNotification;
+extern NSString *const CHChartAreaOldPageKey;
+
 
 /**
  *	Describes a rectangular area on a chart.
@@ -34,9 +41,10 @@
 
 @property (nonatomic, weak) CHChart *chart;					///< The chart to which we belong
 @property (nonatomic, weak) CHChartArea *parent;			///< Our parent area (if any)
-@property (nonatomic, copy) NSString *type;					///< The type of the area
-@property (nonatomic, copy) NSArray *outlinePoints;			///< An array of CGPoints (in NSValues) that define the path for our outline
-@property (nonatomic, copy) NSDictionary *dictionary;		///< The dictionary representation defining the receiver, kept around to spawn the view objects
+@property (nonatomic, copy) NSString *type;					///< The type of the area, interned
+@property (nonatomic, copy) NSData *outlineData;			///< The CGPoints that define the path for our outline, packed into NSData
+@property (nonatomic, copy) NSArray *outlinePoints;			///< The outline as an array of CGPoints (in NSValues), backed by "outlineData"
+@property (nonatomic, copy) NSDictionary *dictionary;		///< The JSON properties we don't parse ourselves; kept as serialized JSON and decoded on first access
 
 @property (nonatomic, assign) NSUInteger page;				///< 1 by default. The page number of the PDF this area resides on
 @property (nonatomic, assign) CGRect frame;					///< The frame as specified
@@ -45,20 +53,25 @@
 @property (nonatomic, assign) CGFloat frameSizeWidth;
 @property (nonatomic, assign) CGFloat frameSizeHeight;
 
-@property (nonatomic, copy) NSString *fontName;				///< Text areas: font name
-@property (nonatomic, strong) NSNumber *fontSize;			///< Text areas: font size
-
-@property (nonatomic, copy) NSString *dataType;				///< Value areas: data type
-
-@property (nonatomic, copy) NSString *xAxisUnitName;		///< Plot areas: X axis unit name
-@property (nonatomic, copy) NSString *xAxisDataType;		///< Plot areas: X axis data type
-@property (nonatomic, strong) NSDecimalNumber *xAxisFrom;	///< Plot areas: X axis starting point
-@property (nonatomic, strong) NSDecimalNumber *xAxisTo;		///< Plot areas: X axis ending point
-@property (nonatomic, copy) NSString *yAxisUnitName;		///< Plot areas: Y axis unit name
-@property (nonatomic, copy) NSString *yAxisDataType;		///< Plot areas: Y axis data type
-@property (nonatomic, strong) NSDecimalNumber *yAxisFrom;	///< Plot areas: Y axis starting point
-@property (nonatomic, strong) NSDecimalNumber *yAxisTo;		///< Plot areas: Y axis ending point
-@property (nonatomic, copy) NSString *statsSource;			///< Plot areas: The source for eventual statistics
+@property (nonatomic, copy) NSString *fontName;				///< Text areas: font name, interned
+@property (nonatomic, assign) CGFloat fontSizeValue;		///< Text areas: font size, 0 if none is set
+@property (nonatomic, strong) NSNumber *fontSize;			///< Text areas: font size as NSNumber, backed by "fontSizeValue"
+
+@property (nonatomic, copy) NSString *dataType;				///< Value areas: data type, interned
+
+@property (nonatomic, copy) NSString *xAxisUnitName;		///< Plot areas: X axis unit name, interned
+@property (nonatomic, copy) NSString *xAxisDataType;		///< Plot areas: X axis data type, interned
+@property (nonatomic, assign) CHDecimal xAxisFromDecimal;	///< Plot areas: X axis starting point
+@property (nonatomic, assign) CHDecimal xAxisToDecimal;		///< Plot areas: X axis ending point
+@property (nonatomic, copy) NSString *yAxisUnitName;		///< Plot areas: Y axis unit name, interned
+@property (nonatomic, copy) NSString *yAxisDataType;		///< Plot areas: Y axis data type, interned
+@property (nonatomic, assign) CHDecimal yAxisFromDecimal;	///< Plot areas: Y axis starting point
+@property (nonatomic, assign) CHDecimal yAxisToDecimal;		///< Plot areas: Y axis ending point
+@property (nonatomic, copy) NSDecimalNumber *xAxisFrom;		///< "xAxisFromDecimal" as NSDecimalNumber, for bindings
+@property (nonatomic, copy) NSDecimalNumber *xAxisTo;		///< "xAxisToDecimal" as NSDecimalNumber, for bindings
+@property (nonatomic, copy) NSDecimalNumber *yAxisFrom;		///< "yAxisFromDecimal" as NSDecimalNumber, for bindings
+@property (nonatomic, copy) NSDecimalNumber *yAxisTo;		///< "yAxisToDecimal" as NSDecimalNumber, for bindings
+@property (nonatomic, copy) NSString *statsSource;			///< Plot areas: The source for eventual statistics, interned
 
 @property (nonatomic, assign) BOOL topmost;					///< YES if this area lies directly on the PDF, i.e. not nested in another area
 @property (nonatomic, copy) NSArray *areas;					///< An area can have any number of subareas
@@ -67,14 +80,28 @@
 
 - (BOOL)hasViewForParent:(id)parentView;
 - (CHChartAreaView *)viewForParent:(id)parentView;
+- (void)forgetView:(CHChartAreaView *)view;
 
 - (void)addArea:(CHChartArea *)newArea;
 - (void)remove;
 
+- (NSUInteger)estimatedMemoryFootprint;
+
 - (NSSet *)plotDataTypes;
 - (BOOL)hasDataType:(NSString *)dataType recursive:(BOOL)recursive;
 - (BOOL)plotsDataType:(NSString *)dataType recursive:(BOOL)recursive;
 
+- (NSArray *)percentileCurves:(NSArray *)percentiles forGender:(CHGender)gender pixelSize:(CGSize)pixelSize;
+- (void)invalidatePercentileCurves;
+
++ (void)beginTransaction;
++ (void)commitTransaction;
++ (void)commitTransactionWithUndoManager:(NSUndoManager *)undoManager actionName:(NSString *)actionName;
++ (void)rollbackTransaction;
++ (BOOL)isInTransaction;
+
++ (void)registerStatsSource:(id<CHStatsSource>)source forName:(NSString *)name;
++ (id<CHStatsSource>)statsSourceNamed:(NSString *)name;
 + (NSCharacterSet *)outlinePathSplitSet;
 
 @end
@@ -22,11 +22,81 @@
 
 #import "CHChartArea.h"
 #import "CHChartAreaView.h"
+#import "CHUnit.h"
+#import "CHStringTable.h"
+#import "CHLMSStatsSource.h"
+#import <objc/runtime.h>
 
 
-@interface CHChartArea ()
+/// How far, in pixels, a tessellated percentile curve may deviate from the true curve
+static const CGFloat kCHPercentileCurveTolerance = 0.5f;
+
+/// Number of segments a percentile curve starts out with before being subdivided
+static const NSUInteger kCHPercentileCurveInitialSegments = 8;
+
+
+/**
+ *  What we need to evaluate one percentile curve.
+ */
+typedef struct {
+	__unsafe_unretained id<CHStatsSource> source;
+	__unsafe_unretained NSString *dataType;
+	CHGender gender;
+	double percentile;
+	double ageFrom;
+	double ageSpan;
+	double valueFrom;
+	double valueSpan;
+	BOOL ageOnX;
+	CGFloat tolerance;
+	NSUInteger maxDepth;
+} CHPercentileCurveContext;
+
+
+NSString *const CHChartAreaTransactionDidCommitNotification = @"CHChartAreaTransactionDidCommitNotification";
+NSString *const CHChartAreaTransactionChangedAreasKey = @"CHChartAreaTransactionChangedAreas";
+NSString *const CHChartAreaPageDidChangeNotification = @"CHChartAreaPageDidChangeNotification";
+NSString *const CHChartAreaOldPageKey = @"CHChartAreaOldPage";
+
+static NSUInteger transactionDepth = 0;						///< How many transactions are open, only used from the main thread
+static NSMapTable *transactionOriginalFrames = nil;			///< The frames areas had when they were first changed in the current transaction
+
+/** NSValue's rect methods differ between AppKit and UIKit, so we box frames ourselves. */
+static NSValue *CHChartAreaValueWithRect(CGRect rect)
+{
+	return [NSValue valueWithBytes:&rect objCType:@encode(CGRect)];
+}
+
+static CGRect CHChartAreaRectFromValue(NSValue *value)
+{
+	CGRect rect = CGRectZero;
+	[value getValue:&rect];
+	return rect;
+}
+
+static CHStringTable *typeTable = nil;
+static CHStringTable *dataTypeTable = nil;
+static CHStringTable *unitTable = nil;
+static CHStringTable *fontTable = nil;
+static CHStringTable *statsSourceTable = nil;
+
+
+@interface CHChartArea () {
+	CHStringID typeID;
+	CHStringID dataTypeID;
+	CHStringID fontNameID;
+	CHStringID xAxisUnitNameID;
+	CHStringID xAxisDataTypeID;
+	CHStringID yAxisUnitNameID;
+	CHStringID yAxisDataTypeID;
+	CHStringID statsSourceID;
+}
 
 @property (nonatomic, strong) NSMapTable *knownViews;
+@property (nonatomic, strong) NSMutableDictionary *percentileCurveCache;		///< Holds arrays of NSData polylines, see "percentileCurves:forGender:pixelSize:"
+@property (nonatomic, assign) NSUInteger percentileCurveGeneration;			///< The stats source generation the cached curves were made with
+@property (nonatomic, copy) NSData *unknownJSON;								///< The JSON properties backing "dictionary", serialized
+@property (nonatomic, copy) NSDictionary *decodedDictionary;					///< "unknownJSON" decoded, once "dictionary" has been asked for
 
 @end
 
@@ -34,6 +104,22 @@
 @implementation CHChartArea
 
 
++ (void)initialize
+{
+	if ([CHChartArea class] == self) {
+		typeTable = [CHStringTable sharedTableNamed:@"type"];
+		dataTypeTable = [CHStringTable sharedTableNamed:@"dataType"];
+		unitTable = [CHStringTable sharedTableNamed:@"unit"];
+		fontTable = [CHStringTable sharedTableNamed:@"font"];
+		statsSourceTable = [CHStringTable sharedTableNamed:@"statsSource"];
+		
+		// the reference the bundled WHO charts name as their source
+		[self registerStatsSource:[CHLMSStatsSource who2006Source] forName:@"WHO.2006"];
+	}
+}
+
+
+
 #pragma mark - JSON Handling
 + (id)newFromJSONObject:(id)object
 {
@@ -73,14 +159,15 @@
 	
 	NSDictionary *dict = (NSDictionary *)object;
 	NSMutableDictionary *muteDict = [dict mutableCopy];
+	[muteDict removeObjectsForKeys:[[self class] knownJSONKeys]];
 	
 	// type
-	self.type = dict[@"type"];
-	if (![_type isKindOfClass:[NSString class]]) {
-		DLog(@"\"type\" must be a NSString, but I got a %@, using its description", NSStringFromClass([_type class]));
-		self.type = [_type description];
+	NSString *aType = dict[@"type"];
+	if (aType && ![aType isKindOfClass:[NSString class]]) {
+		DLog(@"\"type\" must be a NSString, but I got a %@, using its description", NSStringFromClass([aType class]));
+		aType = [aType description];
 	}
-	[muteDict removeObjectForKey:@"type"];
+	self.type = aType;
 	
 	// page
 	NSNumber *pageNumber = dict[@"page"];
@@ -94,7 +181,6 @@
 			pageNum = [pageNumber integerValue];
 		}
 		self.page = pageNum;
-		[muteDict removeObjectForKey:@"page"];
 	}
 	
 	// frame
@@ -116,17 +202,17 @@
 	if ([outlineString isKindOfClass:[NSString class]]) {
 		NSArray *points = [outlineString componentsSeparatedByCharactersInSet:[[self class] outlinePathSplitSet]];
 		if ([points count] > 2) {
-			NSMutableArray *outPoints = [NSMutableArray arrayWithCapacity:[points count]];
+			NSMutableData *outPoints = [NSMutableData dataWithCapacity:[points count] * sizeof(CGPoint)];
 			for (NSString *pointStr in points) {
 #if TARGET_OS_IPHONE
 				CGPoint point = CGPointFromString(pointStr);
-				[outPoints addObject:[NSValue valueWithCGPoint:point]];
 #else
-				NSPoint point = NSPointFromString(pointStr);
-				[outPoints addObject:[NSValue valueWithPoint:point]];
+				NSPoint nsPoint = NSPointFromString(pointStr);
+				CGPoint point = CGPointMake(nsPoint.x, nsPoint.y);
 #endif
+				[outPoints appendBytes:&point length:sizeof(CGPoint)];
 			}
-			self.outlinePoints = outPoints;
+			self.outlineData = outPoints;
 		}
 		else {
 			DLog(@"\"outline\" must describe 3 or more points, but I got this: \"%@\"", outlineString);
@@ -143,7 +229,7 @@
 	}
 	NSNumber *aFontSize = dict[@"fontSize"];
 	if ([aFontSize isKindOfClass:[NSNumber class]]) {
-		self.fontSize = aFontSize;
+		self.fontSizeValue = [aFontSize doubleValue];
 	}
 	else if (aFontSize) {
 		DLog(@"\"fontSize\" must be a number, but I got a %@, discarding", NSStringFromClass([aFontSize class]));
@@ -163,15 +249,15 @@
 		NSDictionary *xAxisDict = axesDict[@"x"];
 		self.xAxisUnitName = xAxisDict[@"unit"];
 		self.xAxisDataType = xAxisDict[@"dataType"];
-		self.xAxisFrom = [NSDecimalNumber decimalNumberWithString:[xAxisDict[@"from"] description]];
-		self.xAxisTo = [NSDecimalNumber decimalNumberWithString:[xAxisDict[@"to"] description]];
+		self.xAxisFromDecimal = CHDecimalFromString([xAxisDict[@"from"] description]);
+		self.xAxisToDecimal = CHDecimalFromString([xAxisDict[@"to"] description]);
 		
 		// y
 		NSDictionary *yAxisDict = axesDict[@"y"];
 		self.yAxisUnitName = yAxisDict[@"unit"];
 		self.yAxisDataType = yAxisDict[@"dataType"];
-		self.yAxisFrom = [NSDecimalNumber decimalNumberWithString:[yAxisDict[@"from"] description]];
-		self.yAxisTo = [NSDecimalNumber decimalNumberWithString:[yAxisDict[@"to"] description]];
+		self.yAxisFromDecimal = CHDecimalFromString([yAxisDict[@"from"] description]);
+		self.yAxisToDecimal = CHDecimalFromString([yAxisDict[@"to"] description]);
 		
 		// stats source
 		NSString *statsSource = dict[@"statsSource"];
@@ -182,7 +268,7 @@
 			DLog(@"\"statsSource\" should be a string, but got a %@, discarding", NSStringFromClass([statsSource class]));
 		}
 	}
-	else if ([@"plot" isEqualToString:_type]) {
+	else if ([@"plot" isEqualToString:self.type]) {
 		DLog(@"This plot area does not have axes!  %@", dict);
 	}
 	
@@ -210,7 +296,6 @@
 	else if (areas) {
 		DLog(@"\"areas\" must be an array, but I got a %@, discarding", NSStringFromClass([areas class]));
 	}
-	[muteDict removeObjectForKey:@"areas"];
 	
 	// remember all the other properties
 	self.dictionary = muteDict;
@@ -220,69 +305,67 @@
 
 - (id)jsonObject
 {
-	if ([_type length] < 1) {
+	if ([self.type length] < 1) {
 		DLog(@"This area does not have a type, not returning a JSON object");
 		return nil;
 	}
 	
 	// basic properties
-	_type = [_type lowercaseString];
-	NSMutableDictionary *dict = [NSMutableDictionary dictionaryWithObject:_type forKey:@"type"];
+	typeID = [typeTable idForString:[self.type lowercaseString]];
+	NSMutableDictionary *dict = [NSMutableDictionary dictionaryWithObject:self.type forKey:@"type"];
 	if (_topmost && _page > 0) {
 		dict[@"page"] = @(_page);
 	}
 	dict[@"rect"] = [self frameString];
 	
 	// the outline
-	if ([_outlinePoints count] > 2) {
-		NSMutableArray *points = [NSMutableArray arrayWithCapacity:[_outlinePoints count]];
-		for (NSValue *point in _outlinePoints) {
-#if TARGET_OS_IPHONE
-			[points addObject:NSStringFromCGPoint([point CGPointValue])];
-#else
-			[points addObject:NSStringFromCGPoint([point pointValue])];
-#endif
+	NSUInteger numOutlinePoints = [_outlineData length] / sizeof(CGPoint);
+	if (numOutlinePoints > 2) {
+		const CGPoint *outline = [_outlineData bytes];
+		NSMutableArray *points = [NSMutableArray arrayWithCapacity:numOutlinePoints];
+		for (NSUInteger i = 0; i < numOutlinePoints; i++) {
+			[points addObject:NSStringFromCGPoint(outline[i])];
 		}
 		NSString *pointString = [points componentsJoinedByString:@";"];
 		if ([pointString length] > 0) {
 			dict[@"outline"] = pointString;
 		}
 	}
-	else if ([_outlinePoints count] > 0) {
-		DLog(@"We need at least 3 outline points, %d are worthless", (int)[_outlinePoints count]);
+	else if (numOutlinePoints > 0) {
+		DLog(@"We need at least 3 outline points, %d are worthless", (int)numOutlinePoints);
 	}
 	
 	// plot areas
-	if ([@"plot" isEqualToString:_type]) {
+	if ([@"plot" isEqualToString:self.type]) {
 		NSDictionary *x = @{
-			@"dataType": _xAxisDataType ? _xAxisDataType : @"",
-			@"unit": _xAxisUnitName ? _xAxisUnitName : @"",
-			@"from": _xAxisFrom ? _xAxisFrom : @0,
-			@"to": _xAxisTo ? _xAxisTo : @0
+			@"dataType": self.xAxisDataType ? self.xAxisDataType : @"",
+			@"unit": self.xAxisUnitName ? self.xAxisUnitName : @"",
+			@"from": CHDecimalIsDefined(_xAxisFromDecimal) ? self.xAxisFrom : @0,
+			@"to": CHDecimalIsDefined(_xAxisToDecimal) ? self.xAxisTo : @0
 		};
 		NSDictionary *y = @{
-			@"dataType": _yAxisDataType ? _yAxisDataType : @"",
-			@"unit": _yAxisUnitName ? _yAxisUnitName : @"",
-			@"from": _yAxisFrom ? _yAxisFrom : @0,
-			@"to": _yAxisTo ? _yAxisTo : @0
+			@"dataType": self.yAxisDataType ? self.yAxisDataType : @"",
+			@"unit": self.yAxisUnitName ? self.yAxisUnitName : @"",
+			@"from": CHDecimalIsDefined(_yAxisFromDecimal) ? self.yAxisFrom : @0,
+			@"to": CHDecimalIsDefined(_yAxisToDecimal) ? self.yAxisTo : @0
 		};
 		
 		dict[@"axes"] = @{@"x": x, @"y": y};
-		if ([_statsSource length] > 0) {
-			dict[@"statsSource"] = _statsSource;
+		if ([self.statsSource length] > 0) {
+			dict[@"statsSource"] = self.statsSource;
 		}
 	}
 	
 	// areas with another type
 	else {
-		if ([_fontName length] > 0) {
-			dict[@"fontName"] = _fontName;
+		if ([self.fontName length] > 0) {
+			dict[@"fontName"] = self.fontName;
 		}
-		if (_fontSize) {
-			dict[@"fontSize"] = _fontSize;
+		if (_fontSizeValue > 0.f) {
+			dict[@"fontSize"] = self.fontSize;
 		}
-		if ([_dataType length] > 0) {
-			dict[@"dataType"] = _dataType;
+		if ([self.dataType length] > 0) {
+			dict[@"dataType"] = self.dataType;
 		}
 	}
 	
@@ -323,14 +406,14 @@
 	NSMutableSet *used = nil;
 	
 	// we are a plot area
-	if ([@"plot" isEqualToString:_type]) {
+	if ([@"plot" isEqualToString:self.type]) {
 		used = [NSMutableSet setWithCapacity:2];
 		
-		if (_xAxisDataType) {
-			[used addObject:_xAxisDataType];
+		if (self.xAxisDataType) {
+			[used addObject:self.xAxisDataType];
 		}
-		if (_yAxisDataType) {
-			[used addObject:_yAxisDataType];
+		if (self.yAxisDataType) {
+			[used addObject:self.yAxisDataType];
 		}
 	}
 	
@@ -358,18 +441,18 @@
 	}
 	
 	// our types
-	if (_dataType) {
-		if ([dataType isEqualToString:_dataType]) {
+	if (self.dataType) {
+		if ([dataType isEqualToString:self.dataType]) {
 			return YES;
 		}
 	}
-	if (_xAxisDataType) {
-		if ([dataType isEqualToString:_xAxisDataType]) {
+	if (self.xAxisDataType) {
+		if ([dataType isEqualToString:self.xAxisDataType]) {
 			return YES;
 		}
 	}
-	if (_yAxisDataType) {
-		if ([dataType isEqualToString:_yAxisDataType]) {
+	if (self.yAxisDataType) {
+		if ([dataType isEqualToString:self.yAxisDataType]) {
 			return YES;
 		}
 	}
@@ -396,14 +479,14 @@
 	}
 	
 	// make sure we are a plot area and check our axes
-	if ([@"plot" isEqualToString:_type]) {
-		if (_xAxisDataType) {
-			if ([dataType isEqualToString:_xAxisDataType]) {
+	if ([@"plot" isEqualToString:self.type]) {
+		if (self.xAxisDataType) {
+			if ([dataType isEqualToString:self.xAxisDataType]) {
 				return YES;
 			}
 		}
-		if (_yAxisDataType) {
-			if ([dataType isEqualToString:_yAxisDataType]) {
+		if (self.yAxisDataType) {
+			if ([dataType isEqualToString:self.yAxisDataType]) {
 				return YES;
 			}
 		}
@@ -440,8 +523,8 @@
 		self.areas = [_areas arrayByAddingObject:newArea];
 	}
 	
-	// tell our views
-	for (id forView in _knownViews) {
+	// tell our views; they may be replaced while we tell them, so loop a snapshot
+	for (id forView in [[_knownViews keyEnumerator] allObjects]) {
 		CHChartAreaView *myView = [_knownViews objectForKey:forView];
 		CHChartAreaView *newView = [myView didAddArea:newArea];
 		if ([[newView window] isKeyWindow]) {
@@ -452,8 +535,8 @@
 
 - (void)remove
 {
-	// remove our views
-	for (id forView in _knownViews) {
+	// remove our views; removing puts them into the reuse pool, which makes us forget them, so loop a snapshot
+	for (id forView in [[_knownViews keyEnumerator] allObjects]) {
 		if ([forView respondsToSelector:@selector(didRemoveArea:)]) {
 			[forView performSelector:@selector(didRemoveArea:) withObject:self];
 		}
@@ -494,9 +577,12 @@
 		return view;
 	}
 	
-	// nope, don't have one!
-	Class viewClass = [CHChartAreaView registeredClassForType:_type];
-	view = [viewClass new];
+	// nope, don't have one! Try to reuse one first
+	view = [CHChartAreaView dequeueReusableViewForType:self.type];
+	if (!view) {
+		Class viewClass = [CHChartAreaView registeredClassForType:self.type];
+		view = [viewClass new];
+	}
 	if (!view) {
 		DLog(@"Failed to create a view for area %@", self);
 		return nil;
@@ -523,6 +609,18 @@
 	
 	return view;
 }
+
+/**
+ *  Stops tracking the given view, e.g. because it is being reused for another area.
+ */
+- (void)forgetView:(CHChartAreaView *)view
+{
+	for (id parentView in [[_knownViews keyEnumerator] allObjects]) {
+		if (view == [_knownViews objectForKey:parentView]) {
+			[_knownViews removeObjectForKey:parentView];
+		}
+	}
+}
 						   
 						   
 						   
@@ -545,11 +643,718 @@
 	return outlinePathSplitSet;
 }
 
+/**
+ *  The JSON keys we parse ourselves; only the others end up in "dictionary", so nothing is stored twice or goes stale when a property changes.
+ */
++ (NSArray *)knownJSONKeys
+{
+	static NSArray *knownJSONKeys = nil;
+	if (!knownJSONKeys) {
+		knownJSONKeys = @[@"type", @"page", @"rect", @"outline", @"fontName", @"fontSize", @"dataType", @"axes", @"statsSource", @"areas"];
+	}
+	return knownJSONKeys;
+}
+
+/**
+ *  The stats sources known to plot areas, by name. Sources are looked up from worker threads (linter, plot server), so only access it while
+ *  synchronized on the dictionary.
+ */
++ (NSMutableDictionary *)statsSources
+{
+	static NSMutableDictionary *statsSources = nil;
+	static dispatch_once_t onceToken;
+	dispatch_once(&onceToken, ^{
+		statsSources = [NSMutableDictionary new];
+	});
+	return statsSources;
+}
+
+/**
+ *  Bumped whenever a stats source is (re-)registered, which makes cached percentile curves stale. Guarded like "statsSources".
+ */
+static NSUInteger statsSourceGeneration = 0;
+
+/**
+ *  Makes a stats source available to all plot areas whose "statsSource" is the given name. Pass nil to remove a source.
+ */
++ (void)registerStatsSource:(id<CHStatsSource>)source forName:(NSString *)name
+{
+	if ([name length] < 1) {
+		return;
+	}
+	
+	NSMutableDictionary *statsSources = [self statsSources];
+	@synchronized(statsSources) {
+		if (source) {
+			statsSources[name] = source;
+		}
+		else {
+			[statsSources removeObjectForKey:name];
+		}
+		statsSourceGeneration++;
+	}
+}
+
++ (id<CHStatsSource>)statsSourceNamed:(NSString *)name
+{
+	return [self statsSourceNamed:name generation:NULL];
+}
+
+/**
+ *  Looks up the source and the current generation in one go.
+ */
++ (id<CHStatsSource>)statsSourceNamed:(NSString *)name generation:(NSUInteger *)generation
+{
+	NSMutableDictionary *statsSources = [self statsSources];
+	@synchronized(statsSources) {
+		if (generation) {
+			*generation = statsSourceGeneration;
+		}
+		return name ? statsSources[name] : nil;
+	}
+}
+
+
+
+#pragma mark - Interned Properties
+- (NSString *)type
+{
+	return [typeTable stringForID:typeID];
+}
+
+- (void)setType:(NSString *)string
+{
+	typeID = [typeTable idForString:string];
+}
+
+- (NSString *)dataType
+{
+	return [dataTypeTable stringForID:dataTypeID];
+}
+
+- (void)setDataType:(NSString *)string
+{
+	dataTypeID = [dataTypeTable idForString:string];
+}
+
+- (NSString *)fontName
+{
+	return [fontTable stringForID:fontNameID];
+}
+
+- (void)setFontName:(NSString *)string
+{
+	fontNameID = [fontTable idForString:string];
+}
+
+- (NSString *)xAxisUnitName
+{
+	return [unitTable stringForID:xAxisUnitNameID];
+}
+
+- (void)setXAxisUnitName:(NSString *)string
+{
+	CHStringID newID = [unitTable idForString:string];
+	if (newID != xAxisUnitNameID) {
+		xAxisUnitNameID = newID;
+		[self invalidatePercentileCurves];
+	}
+}
+
+- (NSString *)xAxisDataType
+{
+	return [dataTypeTable stringForID:xAxisDataTypeID];
+}
+
+- (void)setXAxisDataType:(NSString *)string
+{
+	CHStringID newID = [dataTypeTable idForString:string];
+	if (newID != xAxisDataTypeID) {
+		xAxisDataTypeID = newID;
+		[self invalidatePercentileCurves];
+	}
+}
+
+- (NSString *)yAxisUnitName
+{
+	return [unitTable stringForID:yAxisUnitNameID];
+}
+
+- (void)setYAxisUnitName:(NSString *)string
+{
+	CHStringID newID = [unitTable idForString:string];
+	if (newID != yAxisUnitNameID) {
+		yAxisUnitNameID = newID;
+		[self invalidatePercentileCurves];
+	}
+}
+
+- (NSString *)yAxisDataType
+{
+	return [dataTypeTable stringForID:yAxisDataTypeID];
+}
+
+- (void)setYAxisDataType:(NSString *)string
+{
+	CHStringID newID = [dataTypeTable idForString:string];
+	if (newID != yAxisDataTypeID) {
+		yAxisDataTypeID = newID;
+		[self invalidatePercentileCurves];
+	}
+}
+
+- (NSString *)statsSource
+{
+	return [statsSourceTable stringForID:statsSourceID];
+}
+
+- (void)setStatsSource:(NSString *)string
+{
+	CHStringID newID = [statsSourceTable idForString:string];
+	if (newID != statsSourceID) {
+		statsSourceID = newID;
+		[self invalidatePercentileCurves];
+	}
+}
+
+
+
+#pragma mark - Packed Properties
+- (NSNumber *)fontSize
+{
+	return (_fontSizeValue > 0.f) ? @(_fontSizeValue) : nil;
+}
+
+- (void)setFontSize:(NSNumber *)fontSize
+{
+	self.fontSizeValue = [fontSize doubleValue];
+}
+
++ (NSSet *)keyPathsForValuesAffectingFontSize
+{
+	return [NSSet setWithObject:@"fontSizeValue"];
+}
+
+- (NSArray *)outlinePoints
+{
+	NSUInteger count = [_outlineData length] / sizeof(CGPoint);
+	if (count < 1) {
+		return nil;
+	}
+	
+	const CGPoint *outline = [_outlineData bytes];
+	NSMutableArray *points = [NSMutableArray arrayWithCapacity:count];
+	for (NSUInteger i = 0; i < count; i++) {
+#if TARGET_OS_IPHONE
+		[points addObject:[NSValue valueWithCGPoint:outline[i]]];
+#else
+		[points addObject:[NSValue valueWithPoint:NSPointFromCGPoint(outline[i])]];
+#endif
+	}
+	return points;
+}
+
+- (void)setOutlinePoints:(NSArray *)outlinePoints
+{
+	NSMutableData *data = [NSMutableData dataWithCapacity:[outlinePoints count] * sizeof(CGPoint)];
+	for (NSValue *value in outlinePoints) {
+#if TARGET_OS_IPHONE
+		CGPoint point = [value CGPointValue];
+#else
+		CGPoint point = NSPointToCGPoint([value pointValue]);
+#endif
+		[data appendBytes:&point length:sizeof(CGPoint)];
+	}
+	self.outlineData = ([data length] > 0) ? data : nil;
+}
+
++ (NSSet *)keyPathsForValuesAffectingOutlinePoints
+{
+	return [NSSet setWithObject:@"outlineData"];
+}
+
+/**
+ *  Decodes the JSON properties on first access and keeps the result, so only areas that are actually inspected pay for the decoded dictionary.
+ */
+- (NSDictionary *)dictionary
+{
+	if (!_unknownJSON) {
+		return nil;
+	}
+	if (!_decodedDictionary) {
+		NSError *error = nil;
+		self.decodedDictionary = [NSJSONSerialization JSONObjectWithData:_unknownJSON options:0 error:&error];
+		if (!_decodedDictionary) {
+			DLog(@"Failed to decode JSON properties: %@", [error localizedDescription]);
+		}
+	}
+	return _decodedDictionary;
+}
+
+- (void)setDictionary:(NSDictionary *)dictionary
+{
+	self.decodedDictionary = nil;
+	if ([dictionary count] < 1) {
+		self.unknownJSON = nil;
+		return;
+	}
+	if (![NSJSONSerialization isValidJSONObject:dictionary]) {
+		DLog(@"Cannot serialize unknown properties, discarding: %@", dictionary);
+		self.unknownJSON = nil;
+		return;
+	}
+	
+	NSError *error = nil;
+	self.unknownJSON = [NSJSONSerialization dataWithJSONObject:dictionary options:0 error:&error];
+	if (!_unknownJSON) {
+		DLog(@"Failed to serialize unknown properties: %@", [error localizedDescription]);
+	}
+}
+
++ (NSSet *)keyPathsForValuesAffectingDictionary
+{
+	return [NSSet setWithObject:@"unknownJSON"];
+}
+
+
+
+#pragma mark - Memory
+/**
+ *  A rough estimate of the bytes the receiver and its subareas occupy. Interned strings live in shared tables and are not counted, see CHStringTable.
+ */
+- (NSUInteger)estimatedMemoryFootprint
+{
+	NSUInteger bytes = class_getInstanceSize([self class]);
+	bytes += [_outlineData length] + [_unknownJSON length] + (_decodedDictionary ? 2 * [_unknownJSON length] : 0);		// decoded objects take about twice the JSON
+	for (NSArray *curves in [_percentileCurveCache allValues]) {
+		for (NSData *curve in curves) {
+			bytes += [curve length];
+		}
+	}
+	for (CHChartArea *subarea in _areas) {
+		bytes += [subarea estimatedMemoryFootprint];
+	}
+	
+	return bytes;
+}
+
+
+
+#pragma mark - Axes
+- (void)setXAxisFromDecimal:(CHDecimal)decimal
+{
+	_xAxisFromDecimal = decimal;
+	[self invalidatePercentileCurves];
+}
+
+- (void)setXAxisToDecimal:(CHDecimal)decimal
+{
+	_xAxisToDecimal = decimal;
+	[self invalidatePercentileCurves];
+}
+
+- (void)setYAxisFromDecimal:(CHDecimal)decimal
+{
+	_yAxisFromDecimal = decimal;
+	[self invalidatePercentileCurves];
+}
+
+- (void)setYAxisToDecimal:(CHDecimal)decimal
+{
+	_yAxisToDecimal = decimal;
+	[self invalidatePercentileCurves];
+}
+
+- (NSDecimalNumber *)xAxisFrom
+{
+	return CHDecimalNumber(_xAxisFromDecimal);
+}
+
+- (void)setXAxisFrom:(NSDecimalNumber *)number
+{
+	self.xAxisFromDecimal = CHDecimalFromNumber(number);
+}
+
++ (NSSet *)keyPathsForValuesAffectingXAxisFrom
+{
+	return [NSSet setWithObject:@"xAxisFromDecimal"];
+}
+
+- (NSDecimalNumber *)xAxisTo
+{
+	return CHDecimalNumber(_xAxisToDecimal);
+}
+
+- (void)setXAxisTo:(NSDecimalNumber *)number
+{
+	self.xAxisToDecimal = CHDecimalFromNumber(number);
+}
+
++ (NSSet *)keyPathsForValuesAffectingXAxisTo
+{
+	return [NSSet setWithObject:@"xAxisToDecimal"];
+}
+
+- (NSDecimalNumber *)yAxisFrom
+{
+	return CHDecimalNumber(_yAxisFromDecimal);
+}
+
+- (void)setYAxisFrom:(NSDecimalNumber *)number
+{
+	self.yAxisFromDecimal = CHDecimalFromNumber(number);
+}
+
++ (NSSet *)keyPathsForValuesAffectingYAxisFrom
+{
+	return [NSSet setWithObject:@"yAxisFromDecimal"];
+}
+
+- (NSDecimalNumber *)yAxisTo
+{
+	return CHDecimalNumber(_yAxisToDecimal);
+}
+
+- (void)setYAxisTo:(NSDecimalNumber *)number
+{
+	self.yAxisToDecimal = CHDecimalFromNumber(number);
+}
+
++ (NSSet *)keyPathsForValuesAffectingYAxisTo
+{
+	return [NSSet setWithObject:@"yAxisToDecimal"];
+}
+
+
+
+#pragma mark - Percentile Curves
+/**
+ *  Evaluates the curve at t (0 to 1 along the age axis) and returns the point in normalized area coordinates.
+ */
+static CGPoint CHPercentileCurvePoint(CHPercentileCurveContext *ctx, double t)
+{
+	double value = [ctx->source valueForDataType:ctx->dataType gender:ctx->gender percentile:ctx->percentile atAge:(ctx->ageFrom + t * ctx->ageSpan)];
+	double normalized = (value - ctx->valueFrom) / ctx->valueSpan;
+	return ctx->ageOnX ? CGPointMake(t, normalized) : CGPointMake(normalized, t);
+}
+
+static BOOL CHPercentileCurvePointIsValid(CGPoint point)
+{
+	return isfinite(point.x) && isfinite(point.y);
+}
+
+/**
+ *  Appends the points after p0 up to and including p1, subdividing at the midpoint as long as the midpoint is further off the chord than the tolerance.
+ *  Where the source can not evaluate the curve a single NaN point is appended to mark the gap.
+ */
+static void CHPercentileCurveSubdivide(CHPercentileCurveContext *ctx, double t0, CGPoint p0, double t1, CGPoint p1, NSUInteger depth, NSMutableData *points)
+{
+	if (depth < ctx->maxDepth && CHPercentileCurvePointIsValid(p0) && CHPercentileCurvePointIsValid(p1)) {
+		double tm = (t0 + t1) / 2.0;
+		CGPoint pm = CHPercentileCurvePoint(ctx, tm);
+		if (CHPercentileCurvePointIsValid(pm)) {
+			CGFloat dx = p1.x - p0.x;
+			CGFloat dy = p1.y - p0.y;
+			CGFloat length = sqrt(dx * dx + dy * dy);
+			CGFloat error = (length > 0.f) ? fabs(dx * (p0.y - pm.y) - dy * (p0.x - pm.x)) / length : hypot(pm.x - p0.x, pm.y - p0.y);
+			if (error > ctx->tolerance) {
+				CHPercentileCurveSubdivide(ctx, t0, p0, tm, pm, depth + 1, points);
+				CHPercentileCurveSubdivide(ctx, tm, pm, t1, p1, depth + 1, points);
+				return;
+			}
+		}
+	}
+	
+	if (CHPercentileCurvePointIsValid(p1)) {
+		[points appendBytes:&p1 length:sizeof(CGPoint)];
+	}
+	else if ([points length] >= sizeof(CGPoint)) {
+		const CGPoint *last = (const CGPoint *)((const char *)[points bytes] + [points length] - sizeof(CGPoint));
+		if (CHPercentileCurvePointIsValid(*last)) {
+			CGPoint gap = CGPointMake(NAN, NAN);
+			[points appendBytes:&gap length:sizeof(CGPoint)];
+		}
+	}
+}
+
+/**
+ *  Returns reference curves for the given percentiles, as polylines in normalized area coordinates.
+ *
+ *  Each curve is an NSData holding CGPoint structs, where {0, 0} is (xAxisFrom, yAxisFrom) and {1, 1} is (xAxisTo, yAxisTo); points outside the
+ *  axes are not clipped. A point with NaN coordinates marks a gap where the source has no data; start a new subpath after it. Curves are subdivided until they are within kCHPercentileCurveTolerance pixels of the true curve when drawn at the given pixel
+ *  size, rounded up to the next power of two so that zooming around does not regenerate them all the time while thumbnails get coarser curves. The
+ *  curves are cached until the axes or the stats source change.
+ *  @param percentiles An array of NSNumbers, e.g. @[@3, @50, @97]
+ *  @param pixelSize The size at which the receiver will be drawn, in device pixels
+ *  @return An array holding one NSData per percentile, nil if we don't plot against age or don't have a stats source
+ */
+- (NSArray *)percentileCurves:(NSArray *)percentiles forGender:(CHGender)gender pixelSize:(CGSize)pixelSize
+{
+	if ([percentiles count] < 1 || [self.statsSource length] < 1) {
+		return nil;
+	}
+	NSUInteger generation = 0;
+	id<CHStatsSource> source = [[self class] statsSourceNamed:self.statsSource generation:&generation];
+	if (!source) {
+		return nil;
+	}
+	
+	// curves made with a source that has since been replaced are useless
+	if (generation != _percentileCurveGeneration) {
+		[_percentileCurveCache removeAllObjects];
+		_percentileCurveGeneration = generation;
+	}
+	
+	NSUInteger level = [[self class] percentileCurveLevelForPixelSize:pixelSize];
+	NSString *key = [NSString stringWithFormat:@"%@|%d|%@|%lu", self.statsSource, (int)gender, [percentiles componentsJoinedByString:@","], (unsigned long)level];
+	NSArray *curves = _percentileCurveCache[key];
+	if (!curves) {
+		curves = [self tessellatePercentileCurves:percentiles forGender:gender source:source level:level];
+		if (curves) {
+			if (!_percentileCurveCache) {
+				self.percentileCurveCache = [NSMutableDictionary new];
+			}
+			_percentileCurveCache[key] = curves;
+		}
+	}
+	return curves;
+}
+
+/**
+ *  Throws away all cached percentile curves; called automatically when our axes or our stats source change.
+ */
+- (void)invalidatePercentileCurves
+{
+	[_percentileCurveCache removeAllObjects];
+}
+
+/**
+ *  The level of detail to use for the given size: the exponent of the next power of two of the larger side, clamped to something sensible.
+ */
++ (NSUInteger)percentileCurveLevelForPixelSize:(CGSize)pixelSize
+{
+	CGFloat larger = MAX(pixelSize.width, pixelSize.height);
+	NSUInteger level = (larger > 1.f) ? (NSUInteger)ceil(log2(larger)) : 0;
+	return MIN(MAX(level, 4), 13);
+}
+
+- (NSArray *)tessellatePercentileCurves:(NSArray *)percentiles forGender:(CHGender)gender source:(id<CHStatsSource>)source level:(NSUInteger)level
+{
+	BOOL ageOnX = [@"age" isEqualToString:self.xAxisDataType];
+	if (!ageOnX && ![@"age" isEqualToString:self.yAxisDataType]) {
+		DLog(@"Plot area with stats source \"%@\" does not plot against age, cannot draw percentiles", self.statsSource);
+		return nil;
+	}
+	
+	// convert the axis limits into the source's units once, so we only do double math per point
+	NSString *dataType = ageOnX ? self.yAxisDataType : self.xAxisDataType;
+	CHUnit *ageUnit = [CHUnit newWithPath:(ageOnX ? self.xAxisUnitName : self.yAxisUnitName)];
+	CHUnit *valueUnit = [CHUnit newWithPath:(ageOnX ? self.yAxisUnitName : self.xAxisUnitName)];
+	CHUnit *sourceAgeUnit = [CHUnit newWithPath:[source ageUnitPath]];
+	CHUnit *sourceValueUnit = [CHUnit newWithPath:[source unitPathForDataType:dataType]];
+	
+	double ageFrom = CHDecimalDoubleValue([ageUnit convertDecimal:(ageOnX ? _xAxisFromDecimal : _yAxisFromDecimal) toUnit:sourceAgeUnit]);
+	double ageTo = CHDecimalDoubleValue([ageUnit convertDecimal:(ageOnX ? _xAxisToDecimal : _yAxisToDecimal) toUnit:sourceAgeUnit]);
+	double valueFrom = CHDecimalDoubleValue([valueUnit convertDecimal:(ageOnX ? _yAxisFromDecimal : _xAxisFromDecimal) toUnit:sourceValueUnit]);
+	double valueTo = CHDecimalDoubleValue([valueUnit convertDecimal:(ageOnX ? _yAxisToDecimal : _xAxisToDecimal) toUnit:sourceValueUnit]);
+	if (!isfinite(ageFrom) || !isfinite(ageTo) || !isfinite(valueFrom) || !isfinite(valueTo) || ageFrom == ageTo || valueFrom == valueTo) {
+		DLog(@"The axes of this plot area cannot be used for percentiles: %@", self);
+		return nil;
+	}
+	
+	CHPercentileCurveContext ctx;
+	ctx.source = source;
+	ctx.dataType = dataType;
+	ctx.gender = gender;
+	ctx.ageFrom = ageFrom;
+	ctx.ageSpan = ageTo - ageFrom;
+	ctx.valueFrom = valueFrom;
+	ctx.valueSpan = valueTo - valueFrom;
+	ctx.ageOnX = ageOnX;
+	ctx.tolerance = kCHPercentileCurveTolerance / (CGFloat)(1 << level);
+	ctx.maxDepth = level;
+	
+	// tessellate each curve
+	NSMutableArray *curves = [NSMutableArray arrayWithCapacity:[percentiles count]];
+	for (NSNumber *percentile in percentiles) {
+		ctx.percentile = [percentile doubleValue];
+		NSMutableData *points = [NSMutableData dataWithCapacity:64 * sizeof(CGPoint)];
+		
+		CGPoint p0 = CHPercentileCurvePoint(&ctx, 0.0);
+		if (CHPercentileCurvePointIsValid(p0)) {
+			[points appendBytes:&p0 length:sizeof(CGPoint)];
+		}
+		for (NSUInteger i = 1; i <= kCHPercentileCurveInitialSegments; i++) {
+			double t = (double)i / kCHPercentileCurveInitialSegments;
+			CGPoint p1 = CHPercentileCurvePoint(&ctx, t);
+			CHPercentileCurveSubdivide(&ctx, t - 1.0 / kCHPercentileCurveInitialSegments, p0, t, p1, 0, points);
+			p0 = p1;
+		}
+		[curves addObject:[points copy]];
+	}
+	
+	return curves;
+}
+
+
+
+#pragma mark - Transactions
+/**
+ *  Opens a transaction. Until the matching commit, frame changes of all areas only update the frame: KVO notifications, view repositioning and undo
+ *  registration are deferred and happen once per area upon commit. Transactions can be nested, only the outermost commit applies the changes.
+ *
+ *  Must be used from the main thread.
+ */
++ (void)beginTransaction
+{
+	if (0 == transactionDepth) {
+		transactionOriginalFrames = [NSMapTable strongToStrongObjectsMapTable];
+	}
+	transactionDepth++;
+}
+
+/**
+ *  Commits the current transaction without registering undo.
+ */
++ (void)commitTransaction
+{
+	[self commitTransactionWithUndoManager:nil actionName:nil];
+}
+
+/**
+ *  Commits the current transaction. When closing the outermost transaction, all changed areas emit their KVO notifications and reposition their views,
+ *  then a CHChartAreaTransactionDidCommitNotification notification is posted with the changed areas.
+ *  @param undoManager If given, the frame changes are registered as a single undo operation
+ *  @param actionName The action name for the undo operation, may be nil
+ */
++ (void)commitTransactionWithUndoManager:(NSUndoManager *)undoManager actionName:(NSString *)actionName
+{
+	if (0 == transactionDepth) {
+		DLog(@"Asked to commit a transaction, but there is none open");
+		return;
+	}
+	if (--transactionDepth > 0) {
+		return;
+	}
+	
+	NSMapTable *originals = transactionOriginalFrames;
+	transactionOriginalFrames = nil;
+	
+	// apply, skipping areas that ended up where they started
+	NSMutableArray *changed = [NSMutableArray arrayWithCapacity:[originals count]];
+	NSMapTable *undoFrames = [NSMapTable strongToStrongObjectsMapTable];
+	for (CHChartArea *area in originals) {
+		CGRect original = CHChartAreaRectFromValue([originals objectForKey:area]);
+		if (CGRectEqualToRect(original, area->_frame)) {
+			continue;
+		}
+		
+		[area applyFrame:area->_frame from:original];
+		[undoFrames setObject:CHChartAreaValueWithRect(original) forKey:area];
+		[changed addObject:area];
+	}
+	
+	if ([changed count] < 1) {
+		return;
+	}
+	
+	// undo as one operation
+	if (undoManager) {
+		[undoManager beginUndoGrouping];
+		[[undoManager prepareWithInvocationTarget:self] applyFrames:undoFrames undoManager:undoManager actionName:actionName];
+		if (actionName) {
+			[undoManager setActionName:actionName];
+		}
+		[undoManager endUndoGrouping];
+	}
+	
+	[[NSNotificationCenter defaultCenter] postNotificationName:CHChartAreaTransactionDidCommitNotification
+														object:nil
+													  userInfo:@{CHChartAreaTransactionChangedAreasKey: changed}];
+}
+
+/**
+ *  Ends the current transaction by putting all areas changed in it back where they were, without registering undo or posting notifications.
+ *
+ *  Like committing, only the outermost call takes effect; a nested transaction's changes are rolled back along with the outermost one.
+ */
++ (void)rollbackTransaction
+{
+	if (0 == transactionDepth) {
+		DLog(@"Asked to roll back a transaction, but there is none open");
+		return;
+	}
+	if (--transactionDepth > 0) {
+		return;
+	}
+	
+	NSMapTable *originals = transactionOriginalFrames;
+	transactionOriginalFrames = nil;
+	for (CHChartArea *area in originals) {
+		CGRect original = CHChartAreaRectFromValue([originals objectForKey:area]);
+		[area applyFrame:original from:original];				// our views may have moved along, reposition them
+	}
+}
+
++ (BOOL)isInTransaction
+{
+	return (transactionDepth > 0);
+}
+
+/**
+ *  Sets the frames in the map table (area -> NSValue) in one transaction; used to undo and redo transactions.
+ */
++ (void)applyFrames:(NSMapTable *)frames undoManager:(NSUndoManager *)undoManager actionName:(NSString *)actionName
+{
+	[self beginTransaction];
+	for (CHChartArea *area in frames) {
+		area.frame = CHChartAreaRectFromValue([frames objectForKey:area]);
+	}
+	[self commitTransactionWithUndoManager:undoManager actionName:actionName];
+}
+
+
+
+#pragma mark - Page
+/**
+ *  Areas on a chart post CHChartAreaPageDidChangeNotification when their page changes, so views indexing areas by page can follow.
+ */
+- (void)setPage:(NSUInteger)page
+{
+	if (page != _page) {
+		NSUInteger oldPage = _page;
+		_page = page;
+		
+		if (_chart) {
+			[[NSNotificationCenter defaultCenter] postNotificationName:CHChartAreaPageDidChangeNotification object:self userInfo:@{CHChartAreaOldPageKey: @(oldPage)}];
+		}
+	}
+}
+
 
 
 #pragma mark - Frame Utils
 - (void)setFrame:(CGRect)frame
 {
+	if (transactionDepth > 0) {
+		if (![transactionOriginalFrames objectForKey:self]) {
+			[transactionOriginalFrames setObject:CHChartAreaValueWithRect(_frame) forKey:self];
+		}
+		_frame = frame;
+		return;
+	}
+	
+	[self applyFrame:frame from:_frame];
+}
+
+/**
+ *  Sets the frame, notifying KVO observers and repositioning our views.
+ *
+ *  Observers see "old" as the old value, even when committing a transaction where _frame already holds the new frame.
+ */
+- (void)applyFrame:(CGRect)frame from:(CGRect)oldFrame
+{
+	_frame = oldFrame;
 	[self willChangeValueForKey:@"frame"];
 	[self willChangeValueForKey:@"frameOriginX"];
 	[self willChangeValueForKey:@"frameOriginY"];
@@ -571,6 +1376,17 @@
 	[self didChangeValueForKey:@"frameSizeHeight"];
 }
 
+/**
+ *  We send frame change notifications ourselves, so they can be deferred during transactions.
+ */
++ (BOOL)automaticallyNotifiesObserversForKey:(NSString *)key
+{
+	if ([key hasPrefix:@"frame"]) {
+		return NO;
+	}
+	return [super automaticallyNotifiesObserversForKey:key];
+}
+
 - (CGFloat)frameOriginX
 {
 	return _frame.origin.x;
@@ -624,7 +1440,7 @@
 #pragma mark - Utilities
 - (NSString *)description
 {
-	return [NSString stringWithFormat:@"%@ <%p> type \"%@\", %d sub-areas", NSStringFromClass([self class]), self, _type, (int)[_areas count]];
+	return [NSString stringWithFormat:@"%@ <%p> type \"%@\", %d sub-areas", NSStringFromClass([self class]), self, self.type, (int)[_areas count]];
 }
 
 
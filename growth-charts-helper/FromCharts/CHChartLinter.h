@@ -0,0 +1,55 @@
+//
+//  CHChartLinter.h
+//  Charts
+//
+//  Created by Pascal Pfiffner on 10/19/26.
+//  Copyright (c) 2026 Boston Children's Hospital. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+@class CHChart;
+@class CHChartArea;
+
+
+/**
+ *  How bad a lint finding is.
+ */
+typedef NS_ENUM(unsigned int, CHLintSeverity) {
+	CHLintSeverityWarning = 0,					///< Probably a mistake, but the chart still works
+	CHLintSeverityError							///< The chart will not work as intended
+};
+
+
+/**
+ *  One finding of the linter.
+ */
+@interface CHLintDiagnostic : NSObject
+
+@property (nonatomic, assign) CHLintSeverity severity;
+@property (nonatomic, copy) NSString *code;					///< A short, stable identifier for the check, e.g. "overlap" or "unit-unknown"
+@property (nonatomic, copy) NSString *message;				///< A human readable description
+@property (nonatomic, strong) CHChart *chart;				///< The chart the finding is about
+@property (nonatomic, strong) CHChartArea *area;			///< The area the finding is about, if any
+@property (nonatomic, strong) CHChartArea *otherArea;		///< The second area for findings involving two areas, e.g. overlaps
+
++ (instancetype)diagnosticWithSeverity:(CHLintSeverity)severity code:(NSString *)code chart:(CHChart *)chart area:(CHChartArea *)area message:(NSString *)message;
+
+- (NSDictionary *)jsonObject;
+
+@end
+
+
+/**
+ *  Validates charts and their areas.
+ *
+ *  Checks for overlapping sibling areas, areas extending outside their parent, topmost areas on pages the chart's PDF doesn't have, plot areas with
+ *  missing, empty or inverted axes or unknown units, and outlines with fewer than 3 points. Charts without a PDF get a "no-document" warning since
+ *  their pages can't be checked. Overlaps are found by sweeping over the areas with an interval tree, in O(n log n) plus the number of overlaps.
+ */
+@interface CHChartLinter : NSObject
+
+- (NSArray *)lintChart:(CHChart *)chart;
+- (NSArray *)lintCharts:(NSArray *)charts;
+
+@end
@@ -0,0 +1,493 @@
+//
+//  CHChartLinter.m
+//  Charts
+//
+//  Created by Pascal Pfiffner on 10/19/26.
+//  Copyright (c) 2026 Boston Children's Hospital. All rights reserved.
+//
+
+#import "CHChartLinter.h"
+#import "CHChart.h"
+#import "CHChartArea.h"
+#import "CHUnit.h"
+
+
+static const CGFloat kCHChartLinterEpsilon = 0.0001f;			///< Frames are relative, so edges this close count as touching, not overlapping
+
+
+/**
+ *  An area's frame as used while sweeping.
+ */
+typedef struct {
+	CGFloat minX;
+	CGFloat maxX;
+	CGFloat minY;
+	CGFloat maxY;
+	NSUInteger index;				///< The area's index in the siblings array
+	NSUInteger position;			///< The rect's index after sorting by minX, which is also its node in the interval tree
+} CHLintRect;
+
+static int CHLintRectCompareMinX(const void *a, const void *b)
+{
+	CGFloat ax = ((const CHLintRect *)a)->minX;
+	CGFloat bx = ((const CHLintRect *)b)->minX;
+	return (ax < bx) ? -1 : ((ax > bx) ? 1 : 0);
+}
+
+static int CHLintRectCompareMaxX(const void *a, const void *b)
+{
+	CGFloat ax = ((const CHLintRect *)a)->maxX;
+	CGFloat bx = ((const CHLintRect *)b)->maxX;
+	return (ax < bx) ? -1 : ((ax > bx) ? 1 : 0);
+}
+
+
+/**
+ *  A node of the interval tree holding the open rects while sweeping. The tree is a treap ordered by (minY, position), each node knowing the highest
+ *  maxY in its subtree so that queries can skip subtrees ending below the query. Nodes are indices into the rects array, -1 is no node.
+ */
+typedef struct {
+	NSInteger left;
+	NSInteger right;
+	uint32_t priority;
+	CGFloat subtreeMaxY;
+	BOOL inTree;
+	BOOL closed;					///< Closed before it was opened, because it has no width
+} CHLintNode;
+
+/** A pseudo-random but reproducible priority, so the tree stays balanced no matter in which order the rects come. */
+static uint32_t CHLintNodePriority(NSUInteger position)
+{
+	uint32_t x = (uint32_t)position * 2654435761u + 1;
+	x ^= x >> 16;
+	x *= 0x45d9f3bu;
+	x ^= x >> 16;
+	return x;
+}
+
+static BOOL CHLintNodeLess(const CHLintRect *rects, NSInteger a, NSInteger b)
+{
+	return (rects[a].minY < rects[b].minY) || (rects[a].minY == rects[b].minY && a < b);
+}
+
+static void CHLintNodeUpdate(CHLintNode *nodes, const CHLintRect *rects, NSInteger n)
+{
+	CGFloat maxY = rects[n].maxY;
+	if (nodes[n].left >= 0) {
+		maxY = MAX(maxY, nodes[nodes[n].left].subtreeMaxY);
+	}
+	if (nodes[n].right >= 0) {
+		maxY = MAX(maxY, nodes[nodes[n].right].subtreeMaxY);
+	}
+	nodes[n].subtreeMaxY = maxY;
+}
+
+static NSInteger CHLintTreeInsert(CHLintNode *nodes, const CHLintRect *rects, NSInteger root, NSInteger n)
+{
+	if (root < 0) {
+		nodes[n].left = -1;
+		nodes[n].right = -1;
+		nodes[n].subtreeMaxY = rects[n].maxY;
+		return n;
+	}
+	if (CHLintNodeLess(rects, n, root)) {
+		nodes[root].left = CHLintTreeInsert(nodes, rects, nodes[root].left, n);
+		if (nodes[nodes[root].left].priority > nodes[root].priority) {		// rotate right
+			NSInteger pivot = nodes[root].left;
+			nodes[root].left = nodes[pivot].right;
+			nodes[pivot].right = root;
+			CHLintNodeUpdate(nodes, rects, root);
+			root = pivot;
+		}
+	}
+	else {
+		nodes[root].right = CHLintTreeInsert(nodes, rects, nodes[root].right, n);
+		if (nodes[nodes[root].right].priority > nodes[root].priority) {		// rotate left
+			NSInteger pivot = nodes[root].right;
+			nodes[root].right = nodes[pivot].left;
+			nodes[pivot].left = root;
+			CHLintNodeUpdate(nodes, rects, root);
+			root = pivot;
+		}
+	}
+	CHLintNodeUpdate(nodes, rects, root);
+	return root;
+}
+
+static NSInteger CHLintTreeMerge(CHLintNode *nodes, const CHLintRect *rects, NSInteger a, NSInteger b)
+{
+	if (a < 0) {
+		return b;
+	}
+	if (b < 0) {
+		return a;
+	}
+	if (nodes[a].priority > nodes[b].priority) {
+		nodes[a].right = CHLintTreeMerge(nodes, rects, nodes[a].right, b);
+		CHLintNodeUpdate(nodes, rects, a);
+		return a;
+	}
+	nodes[b].left = CHLintTreeMerge(nodes, rects, a, nodes[b].left);
+	CHLintNodeUpdate(nodes, rects, b);
+	return b;
+}
+
+static NSInteger CHLintTreeRemove(CHLintNode *nodes, const CHLintRect *rects, NSInteger root, NSInteger n)
+{
+	if (root < 0) {
+		return -1;
+	}
+	if (root == n) {
+		return CHLintTreeMerge(nodes, rects, nodes[n].left, nodes[n].right);
+	}
+	if (CHLintNodeLess(rects, n, root)) {
+		nodes[root].left = CHLintTreeRemove(nodes, rects, nodes[root].left, n);
+	}
+	else {
+		nodes[root].right = CHLintTreeRemove(nodes, rects, nodes[root].right, n);
+	}
+	CHLintNodeUpdate(nodes, rects, root);
+	return root;
+}
+
+/** Appends all nodes whose rect overlaps minY to maxY vertically to "hits", in order of their bottom edge. */
+static void CHLintTreeQuery(const CHLintNode *nodes, const CHLintRect *rects, NSInteger root, CGFloat minY, CGFloat maxY, NSInteger *hits, NSUInteger *numHits)
+{
+	if (root < 0 || nodes[root].subtreeMaxY - kCHChartLinterEpsilon <= minY) {
+		return;
+	}
+	CHLintTreeQuery(nodes, rects, nodes[root].left, minY, maxY, hits, numHits);
+	if (rects[root].minY < maxY - kCHChartLinterEpsilon) {
+		if (minY < rects[root].maxY - kCHChartLinterEpsilon) {
+			hits[(*numHits)++] = root;
+		}
+		CHLintTreeQuery(nodes, rects, nodes[root].right, minY, maxY, hits, numHits);
+	}
+}
+
+
+@implementation CHLintDiagnostic
+
+
++ (instancetype)diagnosticWithSeverity:(CHLintSeverity)severity code:(NSString *)code chart:(CHChart *)chart area:(CHChartArea *)area message:(NSString *)message
+{
+	CHLintDiagnostic *diag = [self new];
+	diag.severity = severity;
+	diag.code = code;
+	diag.chart = chart;
+	diag.area = area;
+	diag.message = message;
+	
+	return diag;
+}
+
+/**
+ *  A dictionary suitable for NSJSONSerialization, areas are represented by their type and frame.
+ */
+- (NSDictionary *)jsonObject
+{
+	NSMutableDictionary *dict = [NSMutableDictionary dictionaryWithCapacity:6];
+	dict[@"severity"] = (CHLintSeverityError == _severity) ? @"error" : @"warning";
+	dict[@"code"] = _code ? _code : @"";
+	dict[@"message"] = _message ? _message : @"";
+	if (_chart.name) {
+		dict[@"chart"] = _chart.name;
+	}
+	if (_area) {
+		dict[@"area"] = @{@"type": (_area.type ? _area.type : @""), @"page": @(_area.page), @"rect": [_area frameString]};
+	}
+	if (_otherArea) {
+		dict[@"otherArea"] = @{@"type": (_otherArea.type ? _otherArea.type : @""), @"page": @(_otherArea.page), @"rect": [_otherArea frameString]};
+	}
+	
+	return dict;
+}
+
+- (NSString *)description
+{
+	return [NSString stringWithFormat:@"%@: %@ [%@] %@", _chart.name, (CHLintSeverityError == _severity) ? @"error" : @"warning", _code, _message];
+}
+
+
+@end
+
+
+
+@implementation CHChartLinter
+
+
+#pragma mark - Linting
+/**
+ *  Lints one chart.
+ *  @return An array of CHLintDiagnostic objects, empty if the chart looks good
+ */
+- (NSArray *)lintChart:(CHChart *)chart
+{
+	return [self lintChart:chart knownUnits:[self knownUnitsInCharts:@[chart]]];
+}
+
+/**
+ *  Lints all charts, distributing them over all cores.
+ *  @return An array of CHLintDiagnostic objects, grouped by chart in the order the charts were given
+ */
+- (NSArray *)lintCharts:(NSArray *)charts
+{
+	NSUInteger count = [charts count];
+	if (count < 1) {
+		return @[];
+	}
+	
+	// resolve units once, so the workers only read an immutable dictionary
+	NSDictionary *knownUnits = [self knownUnitsInCharts:charts];
+	
+	NSMutableArray *perChart = [NSMutableArray arrayWithCapacity:count];
+	for (NSUInteger i = 0; i < count; i++) {
+		[perChart addObject:@[]];
+	}
+	
+	dispatch_apply(count, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t i) {
+		NSArray *diagnostics = [self lintChart:charts[i] knownUnits:knownUnits];
+		@synchronized(perChart) {
+			perChart[i] = diagnostics;
+		}
+	});
+	
+	NSMutableArray *all = [NSMutableArray array];
+	for (NSArray *diagnostics in perChart) {
+		[all addObjectsFromArray:diagnostics];
+	}
+	return all;
+}
+
+- (NSArray *)lintChart:(CHChart *)chart knownUnits:(NSDictionary *)knownUnits
+{
+	NSMutableArray *diagnostics = [NSMutableArray array];
+	
+	// how many pages do we have? The document is a PDFDocument in the app, but we don't want to depend on PDFKit here
+	NSUInteger pageCount = 0;
+	if ([chart.document respondsToSelector:@selector(pageCount)]) {
+		pageCount = [[chart.document valueForKey:@"pageCount"] unsignedIntegerValue];
+	}
+	if (0 == pageCount) {
+		NSString *msg = chart.document ? @"The chart's PDF has no pages, area pages cannot be checked" : @"The chart has no PDF, area pages cannot be checked";
+		[diagnostics addObject:[CHLintDiagnostic diagnosticWithSeverity:CHLintSeverityWarning code:@"no-document" chart:chart area:nil message:msg]];
+	}
+	
+	// topmost areas: check pages and group them by page for the overlap test
+	NSMutableDictionary *byPage = [NSMutableDictionary dictionary];
+	for (CHChartArea *area in chart.chartAreas) {
+		NSUInteger page = (0 == area.page || NSNotFound == area.page) ? 1 : area.page;
+		if (pageCount > 0 && page > pageCount) {
+			NSString *msg = [NSString stringWithFormat:@"Area is on page %lu, but the PDF only has %lu", (unsigned long)page, (unsigned long)pageCount];
+			[diagnostics addObject:[CHLintDiagnostic diagnosticWithSeverity:CHLintSeverityError code:@"page-out-of-range" chart:chart area:area message:msg]];
+		}
+		
+		NSMutableArray *onPage = byPage[@(page)];
+		if (!onPage) {
+			onPage = [NSMutableArray array];
+			byPage[@(page)] = onPage;
+		}
+		[onPage addObject:area];
+	}
+	
+	for (NSNumber *page in byPage) {
+		[self lintSiblings:byPage[page] ofChart:chart knownUnits:knownUnits into:diagnostics];
+	}
+	
+	return diagnostics;
+}
+
+/**
+ *  Lints areas sharing the same parent (or page, for topmost areas), then recurses into their subareas.
+ */
+- (void)lintSiblings:(NSArray *)siblings ofChart:(CHChart *)chart knownUnits:(NSDictionary *)knownUnits into:(NSMutableArray *)diagnostics
+{
+	for (CHChartArea *area in siblings) {
+		[self lintArea:area ofChart:chart knownUnits:knownUnits into:diagnostics];
+	}
+	[self findOverlapsIn:siblings ofChart:chart into:diagnostics];
+	
+	for (CHChartArea *area in siblings) {
+		if ([area.areas count] > 0) {
+			[self lintSiblings:area.areas ofChart:chart knownUnits:knownUnits into:diagnostics];
+		}
+	}
+}
+
+/**
+ *  Checks of a single area.
+ */
+- (void)lintArea:(CHChartArea *)area ofChart:(CHChart *)chart knownUnits:(NSDictionary *)knownUnits into:(NSMutableArray *)diagnostics
+{
+	// containment; frames are relative to the parent (or the page)
+	CGRect frame = area.frame;
+	if (CGRectGetMinX(frame) < -kCHChartLinterEpsilon || CGRectGetMinY(frame) < -kCHChartLinterEpsilon
+		|| CGRectGetMaxX(frame) > 1.f + kCHChartLinterEpsilon || CGRectGetMaxY(frame) > 1.f + kCHChartLinterEpsilon) {
+		NSString *msg = [NSString stringWithFormat:@"Area extends outside its %@: %@", (area.parent ? @"parent" : @"page"), [area frameString]];
+		[diagnostics addObject:[CHLintDiagnostic diagnosticWithSeverity:CHLintSeverityWarning code:@"outside-parent" chart:chart area:area message:msg]];
+	}
+	
+	// outline
+	NSUInteger numOutlinePoints = [area.outlineData length] / sizeof(CGPoint);
+	if (numOutlinePoints > 0 && numOutlinePoints < 3) {
+		NSString *msg = [NSString stringWithFormat:@"Outline has %lu points, needs at least 3", (unsigned long)numOutlinePoints];
+		[diagnostics addObject:[CHLintDiagnostic diagnosticWithSeverity:CHLintSeverityWarning code:@"outline-too-short" chart:chart area:area message:msg]];
+	}
+	
+	// axes of plot areas
+	if ([@"plot" isEqualToString:area.type]) {
+		[self lintAxis:@"X" from:area.xAxisFromDecimal to:area.xAxisToDecimal unit:area.xAxisUnitName ofArea:area chart:chart knownUnits:knownUnits into:diagnostics];
+		[self lintAxis:@"Y" from:area.yAxisFromDecimal to:area.yAxisToDecimal unit:area.yAxisUnitName ofArea:area chart:chart knownUnits:knownUnits into:diagnostics];
+	}
+}
+
+- (void)lintAxis:(NSString *)axis from:(CHDecimal)from to:(CHDecimal)to unit:(NSString *)unitPath ofArea:(CHChartArea *)area chart:(CHChart *)chart
+	  knownUnits:(NSDictionary *)knownUnits into:(NSMutableArray *)diagnostics
+{
+	if (!CHDecimalIsNumber(from) || !CHDecimalIsNumber(to)) {
+		NSString *msg = [NSString stringWithFormat:@"%@ axis is missing its %@", axis, (!CHDecimalIsNumber(from) ? @"start" : @"end")];
+		[diagnostics addObject:[CHLintDiagnostic diagnosticWithSeverity:CHLintSeverityError code:@"axis-missing" chart:chart area:area message:msg]];
+	}
+	else {
+		NSComparisonResult order = CHDecimalCompare(from, to);
+		if (NSOrderedSame == order) {
+			NSString *msg = [NSString stringWithFormat:@"%@ axis starts and ends at %@", axis, CHDecimalString(from)];
+			[diagnostics addObject:[CHLintDiagnostic diagnosticWithSeverity:CHLintSeverityError code:@"axis-empty" chart:chart area:area message:msg]];
+		}
+		else if (NSOrderedDescending == order) {
+			NSString *msg = [NSString stringWithFormat:@"%@ axis is inverted, from %@ to %@", axis, CHDecimalString(from), CHDecimalString(to)];
+			[diagnostics addObject:[CHLintDiagnostic diagnosticWithSeverity:CHLintSeverityWarning code:@"axis-inverted" chart:chart area:area message:msg]];
+		}
+	}
+	
+	if ([unitPath length] < 1) {
+		NSString *msg = [NSString stringWithFormat:@"%@ axis does not have a unit", axis];
+		[diagnostics addObject:[CHLintDiagnostic diagnosticWithSeverity:CHLintSeverityError code:@"unit-missing" chart:chart area:area message:msg]];
+	}
+	else if (![knownUnits[unitPath] boolValue]) {
+		NSString *msg = [NSString stringWithFormat:@"%@ axis has unknown unit \"%@\"", axis, unitPath];
+		[diagnostics addObject:[CHLintDiagnostic diagnosticWithSeverity:CHLintSeverityError code:@"unit-unknown" chart:chart area:area message:msg]];
+	}
+}
+
+
+
+#pragma mark - Overlaps
+/**
+ *  Finds overlapping areas by sorting them by their left edge and sweeping from left to right. The areas still "open" at the current left edge live
+ *  in an interval tree ordered by their bottom edge, so each area only visits the open areas it actually overlaps, plus a logarithmic number of others.
+ */
+- (void)findOverlapsIn:(NSArray *)siblings ofChart:(CHChart *)chart into:(NSMutableArray *)diagnostics
+{
+	NSUInteger count = [siblings count];
+	if (count < 2) {
+		return;
+	}
+	
+	CHLintRect *rects = malloc(count * sizeof(CHLintRect));
+	CHLintRect *byMaxX = malloc(count * sizeof(CHLintRect));
+	CHLintNode *nodes = malloc(count * sizeof(CHLintNode));
+	NSInteger *hits = malloc(count * sizeof(NSInteger));
+	if (!rects || !byMaxX || !nodes || !hits) {
+		free(rects);
+		free(byMaxX);
+		free(nodes);
+		free(hits);
+		return;
+	}
+	
+	NSUInteger i = 0;
+	for (CHChartArea *area in siblings) {
+		CGRect frame = CGRectStandardize(area.frame);
+		rects[i] = (CHLintRect){CGRectGetMinX(frame), CGRectGetMaxX(frame), CGRectGetMinY(frame), CGRectGetMaxY(frame), i, 0};
+		i++;
+	}
+	qsort(rects, count, sizeof(CHLintRect), CHLintRectCompareMinX);
+	for (i = 0; i < count; i++) {
+		rects[i].position = i;
+		nodes[i] = (CHLintNode){-1, -1, CHLintNodePriority(i), rects[i].maxY, NO, NO};
+	}
+	memcpy(byMaxX, rects, count * sizeof(CHLintRect));
+	qsort(byMaxX, count, sizeof(CHLintRect), CHLintRectCompareMaxX);
+	
+	NSInteger root = -1;
+	NSUInteger nextEnd = 0;
+	for (i = 0; i < count; i++) {
+		CHLintRect current = rects[i];
+		
+		// close rects that end before the current one starts; one that hasn't been opened yet has no width and won't be opened at all
+		while (nextEnd < count && byMaxX[nextEnd].maxX - kCHChartLinterEpsilon <= current.minX) {
+			NSUInteger ended = byMaxX[nextEnd++].position;
+			if (nodes[ended].inTree) {
+				root = CHLintTreeRemove(nodes, rects, root, (NSInteger)ended);
+				nodes[ended].inTree = NO;
+			}
+			else {
+				nodes[ended].closed = YES;
+			}
+		}
+		
+		// compare against the open rects overlapping vertically
+		NSUInteger numHits = 0;
+		CHLintTreeQuery(nodes, rects, root, current.minY, current.maxY, hits, &numHits);
+		for (NSUInteger h = 0; h < numHits; h++) {
+			if (rects[hits[h]].minX >= current.maxX - kCHChartLinterEpsilon) {		// only when the current rect is (almost) without width
+				continue;
+			}
+			CHLintDiagnostic *diag = [CHLintDiagnostic diagnosticWithSeverity:CHLintSeverityWarning
+																		code:@"overlap"
+																	   chart:chart
+																		area:siblings[rects[hits[h]].index]
+																	 message:@"Area overlaps a sibling area"];
+			diag.otherArea = siblings[current.index];
+			[diagnostics addObject:diag];
+		}
+		
+		if (!nodes[i].closed) {
+			root = CHLintTreeInsert(nodes, rects, root, (NSInteger)i);
+			nodes[i].inTree = YES;
+		}
+	}
+	
+	free(rects);
+	free(byMaxX);
+	free(nodes);
+	free(hits);
+}
+
+
+
+#pragma mark - Units
+/**
+ *  Collects all axis unit paths used in the charts and looks each up once in the unit registry.
+ *  @return A dictionary with unit paths as keys and NSNumber booleans as values
+ */
+- (NSDictionary *)knownUnitsInCharts:(NSArray *)charts
+{
+	NSMutableSet *paths = [NSMutableSet set];
+	for (CHChart *chart in charts) {
+		[self collectUnitPathsOfAreas:[chart.chartAreas allObjects] into:paths];
+	}
+	
+	NSMutableDictionary *known = [NSMutableDictionary dictionaryWithCapacity:[paths count]];
+	for (NSString *path in paths) {
+		known[path] = @([CHUnit isKnownUnitPath:path]);
+	}
+	return known;
+}
+
+- (void)collectUnitPathsOfAreas:(NSArray *)areas into:(NSMutableSet *)paths
+{
+	for (CHChartArea *area in areas) {
+		if ([area.xAxisUnitName length] > 0) {
+			[paths addObject:area.xAxisUnitName];
+		}
+		if ([area.yAxisUnitName length] > 0) {
+			[paths addObject:area.yAxisUnitName];
+		}
+		[self collectUnitPathsOfAreas:area.areas into:paths];
+	}
+}
+
+
+@end
@@ -17,5 +17,6 @@
 @property (nonatomic, strong) NSDate *referenceDate;			///< Will be used when converting between units, meaning numbers are relative to this date (Jan 1, 2001 by default)
 
 - (NSDate *)dateValueFor:(NSDecimalNumber *)number fromDate:(NSDate *)refDate;
+- (NSDate *)dateValueForDecimal:(CHDecimal)decimal fromDate:(NSDate *)refDate;
 
 @end
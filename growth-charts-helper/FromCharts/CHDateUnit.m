@@ -7,7 +7,6 @@
 //
 
 #import "CHDateUnit.h"
-#import "NSDecimalNumber+Extension.h"
 
 
 @implementation CHDateUnit
@@ -19,10 +18,10 @@
  *  Ages below 2 years will be displayed in months and days.
  *  Ages above 2 years will be displayed in years and months, with days for the "CHValueStringSizeLong" format.
  */
-- (NSString *)stringValueForNumber:(NSDecimalNumber *)number withSize:(CHValueStringSize)size
+- (NSString *)stringValueForDecimal:(CHDecimal)decimal withSize:(CHValueStringSize)size
 {
 	// convert to NSDate and get components
-	NSDate *ageDate = [self dateValueFor:number fromDate:self.referenceDate];
+	NSDate *ageDate = [self dateValueForDecimal:decimal fromDate:self.referenceDate];
 	NSDateComponents *comp = [[NSCalendar currentCalendar] components:(NSYearCalendarUnit | NSMonthCalendarUnit | NSDayCalendarUnit) fromDate:self.referenceDate toDate:ageDate options:0];
 	
 	// compose a string -- year
@@ -78,29 +77,29 @@
 
 
 /**
- *  Convert the given number, assumed to be in the receiver's unit, to the given unit.
+ *  Convert the given decimal, assumed to be in the receiver's unit, to the given unit.
  *
  *  This method applies a calendar-based conversion, which is rather CPU intensive (compared to standard math required for other units). Please also consider
  *  the accuracy of conversions - 1.5 years will be interpreted as 1 year and 6 months, not as 182 or 183 days, which is probably better when compared what
  *  humans expect from such a conversion (i.e. keeping the same day of the month), but sacrifices some accuracy.
  *
- *  @param number A number representing time in the receiver's unit
- *  @param unit The target unit the number should be converted to
- *  @return An NSDecimalNumber representing the number in the desired time unit
+ *  @param decimal A decimal representing time in the receiver's unit
+ *  @param unit The target unit the decimal should be converted to
+ *  @return A decimal representing the time in the desired time unit
  */
-- (NSDecimalNumber *)convertNumber:(NSDecimalNumber *)number toUnit:(CHUnit *)unit
+- (CHDecimal)convertDecimal:(CHDecimal)decimal toUnit:(CHUnit *)unit
 {
 	if (![self isSameDimension:unit]) {
 		DLog(@"I can not convert to a unit from another dimension (%@ -> %@)", self.dimension, unit.dimension);
-		return number;
+		return decimal;
 	}
 	if ([self.name isEqualToString:unit.name]) {
-		return number;
+		return decimal;
 	}
 	
 	// convert current to date
 	NSDate *refDate = self.referenceDate;
-	NSDate *date = [self dateValueFor:number fromDate:refDate];
+	NSDate *date = [self dateValueForDecimal:decimal fromDate:refDate];
 	
 	// convert to other unit
 	double result = 0.0;
@@ -130,27 +129,27 @@
 	}
 	else {
 		DLog(@"I can't convert from \"%@\" to \"%@\" I'm afraid", self.name, unit.name);
-		return number;
+		return decimal;
 	}
 	
-	return [NSDecimalNumber decimalNumberWithString:[NSString stringWithFormat:@"%f", result]];
+	return CHDecimalFromDouble(result, 6);
 }
 
 
 /**
- *  @param number A number representing time in the receiver's unit
- *  @return An NSDecimalNumber representing the given number in seconds
+ *  @param decimal A decimal representing time in the receiver's unit
+ *  @return A decimal representing the given time in seconds
  */
-- (NSDecimalNumber *)numberInBaseUnit:(NSDecimalNumber *)number
+- (CHDecimal)decimalInBaseUnit:(CHDecimal)decimal
 {
 	if ([@"second" isEqualToString:self.name]) {
-		return number;
+		return decimal;
 	}
 	
-	NSDate *date = [self dateValueFor:number fromDate:self.referenceDate];
+	NSDate *date = [self dateValueForDecimal:decimal fromDate:self.referenceDate];
 	
 	NSDateComponents *comp = [[NSCalendar currentCalendar] components:NSSecondCalendarUnit fromDate:self.referenceDate toDate:date options:0];
-	return [NSDecimalNumber decimalNumberWithString:[NSString stringWithFormat:@"%li", (long)comp.second]];
+	return CHDecimalMake(comp.second, 0);
 }
 
 
@@ -160,31 +159,38 @@
  *  @return A date that represents the date with the given numerical distance, in our unit system, from our reference date (2001-01-01 by default)
  */
 - (NSDate *)dateValueFor:(NSDecimalNumber *)number fromDate:(NSDate *)refDate
+{
+	return [self dateValueForDecimal:CHDecimalFromNumber(number) fromDate:refDate];
+}
+
+- (NSDate *)dateValueForDecimal:(CHDecimal)decimal fromDate:(NSDate *)refDate
 {
 	NSDateComponents *comp = [NSDateComponents new];
+	NSInteger integer = CHDecimalIntegerValue(decimal);
+	double fraction = CHDecimalDoubleValue(CHDecimalModulo(decimal, CHDecimalMake(1, 0)));
 	
 	if ([@"year" isEqualToString:self.name]) {
-		comp.year = [number integerValue];
-		comp.month = (NSInteger)([[number decimalPlaces] doubleValue] * 12.0);
+		comp.year = integer;
+		comp.month = (NSInteger)(fraction * 12.0);
 	}
 	else if ([@"month" isEqualToString:self.name]) {
-		comp.month = [number integerValue];
-		comp.day = (NSInteger)([[number decimalPlaces] doubleValue] * 30.5);
+		comp.month = integer;
+		comp.day = (NSInteger)(fraction * 30.5);
 	}
 	else if ([@"week" isEqualToString:self.name]) {
-		comp.week = [number integerValue];
-		comp.day = (NSInteger)([[number decimalPlaces] doubleValue] * 7.0);
+		comp.week = integer;
+		comp.day = (NSInteger)(fraction * 7.0);
 	}
 	else if ([@"day" isEqualToString:self.name]) {
-		comp.day = [number integerValue];
-		comp.second = (NSInteger)([[number decimalPlaces] doubleValue] * 86400.0);
+		comp.day = integer;
+		comp.second = (NSInteger)(fraction * 86400.0);
 	}
 	else if ([@"hour" isEqualToString:self.name]) {
-		comp.hour = [number integerValue];
-		comp.second = (NSInteger)([[number decimalPlaces] doubleValue] * 3600.0);
+		comp.hour = integer;
+		comp.second = (NSInteger)(fraction * 3600.0);
 	}
 	else if ([@"second" isEqualToString:self.name]) {
-		comp.second = [number integerValue];
+		comp.second = integer;
 	}
 	else {
 		DLog(@"I don't know how to treat \"%@\" units I'm afraid", self.name);
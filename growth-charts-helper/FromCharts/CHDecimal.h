@@ -0,0 +1,74 @@
+//
+//  CHDecimal.h
+//  Charts
+//
+//  Created by Pascal Pfiffner on 10/19/26.
+//  Copyright (c) 2026 Boston Children's Hospital. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+
+#define CHDecimalMaxScale 18			///< Max number of digits after the decimal point
+#define CHDecimalMinScale -127			///< Negative scales express trailing zeros, i.e. a scale of -2 multiplies the mantissa by 100
+
+
+/**
+ *  What a CHDecimal represents.
+ */
+typedef NS_ENUM(uint8_t, CHDecimalKind) {
+	CHDecimalKindUndefined = 0,			///< No value at all, what a nil NSDecimalNumber is in the model. A zeroed struct is undefined.
+	CHDecimalKindNumber,
+	CHDecimalKindNotANumber,
+	CHDecimalKindPlusInfinity,			///< Used where we used "maximumDecimalNumber" before
+	CHDecimalKindMinusInfinity			///< Used where we used "minimumDecimalNumber" before
+};
+
+
+/**
+ *  A decimal number stored inline as a scaled 64 bit integer: the value is "mantissa / 10^scale".
+ *
+ *  Parsing is exact up to 18 significant digits, intermediate results use 128 bit math and are rounded (NSRoundPlain) to fit. Use the functions below to
+ *  do math, NSDecimalNumber instances are only needed when handing values to Cocoa (bindings, JSON, NSCoding).
+ */
+typedef struct {
+	int64_t mantissa;
+	int16_t scale;
+	CHDecimalKind kind;
+} CHDecimal;
+
+
+CHDecimal CHDecimalMake(int64_t mantissa, int16_t scale);
+CHDecimal CHDecimalMakeUndefined(void);
+CHDecimal CHDecimalMakeNotANumber(void);
+CHDecimal CHDecimalMakeInfinity(BOOL negative);
+
+CHDecimal CHDecimalFromUTF8(const char *bytes, size_t length, size_t *consumed);
+CHDecimal CHDecimalFromString(NSString *string);
+CHDecimal CHDecimalFromDouble(double value, short scale);
+CHDecimal CHDecimalFromNSDecimal(NSDecimal decimal);
+CHDecimal CHDecimalFromNumber(NSNumber *number);
+
+size_t CHDecimalPrint(CHDecimal decimal, char *buffer, size_t size);
+NSString *CHDecimalString(CHDecimal decimal);
+NSDecimalNumber *CHDecimalNumber(CHDecimal decimal);
+double CHDecimalDoubleValue(CHDecimal decimal);
+NSInteger CHDecimalIntegerValue(CHDecimal decimal);
+
+BOOL CHDecimalIsDefined(CHDecimal decimal);
+BOOL CHDecimalIsNumber(CHDecimal decimal);
+BOOL CHDecimalIsNotANumber(CHDecimal decimal);
+BOOL CHDecimalIsInfinite(CHDecimal decimal);
+
+CHDecimal CHDecimalAdd(CHDecimal a, CHDecimal b);
+CHDecimal CHDecimalSubtract(CHDecimal a, CHDecimal b);
+CHDecimal CHDecimalMultiply(CHDecimal a, CHDecimal b);
+CHDecimal CHDecimalDivide(CHDecimal a, CHDecimal b);
+CHDecimal CHDecimalNegate(CHDecimal decimal);
+CHDecimal CHDecimalAbsolute(CHDecimal decimal);
+CHDecimal CHDecimalModulo(CHDecimal a, CHDecimal b);
+CHDecimal CHDecimalRound(CHDecimal decimal, short scale, NSRoundingMode mode);
+
+NSComparisonResult CHDecimalCompare(CHDecimal a, CHDecimal b);
+CHDecimal CHDecimalGreater(CHDecimal a, CHDecimal b);
+CHDecimal CHDecimalSmaller(CHDecimal a, CHDecimal b);
@@ -0,0 +1,765 @@
+//
+//  CHDecimal.m
+//  Charts
+//
+//  Created by Pascal Pfiffner on 10/19/26.
+//  Copyright (c) 2026 Boston Children's Hospital. All rights reserved.
+//
+
+#import "CHDecimal.h"
+
+
+typedef __int128 CHDecimalWide;
+
+static const CHDecimalWide kCHDecimalMantissaMax = INT64_MAX;
+
+
+#pragma mark - Internal Helpers
+/**
+ *  10^exponent for exponents 0 to 38. 10^39 doesn't fit into 128 bits, so callers must handle larger exponents themselves; they are clamped to 38 here
+ *  so we never read past the table.
+ */
+static CHDecimalWide CHDecimalPow10(int exponent)
+{
+	if (exponent > 38) {
+		DLog(@"10^%d does not fit, using 10^38", exponent);
+		exponent = 38;
+	}
+	static const int64_t powers[19] = {
+		1LL, 10LL, 100LL, 1000LL, 10000LL, 100000LL, 1000000LL, 10000000LL, 100000000LL, 1000000000LL, 10000000000LL, 100000000000LL,
+		1000000000000LL, 10000000000000LL, 100000000000000LL, 1000000000000000LL, 10000000000000000LL, 100000000000000000LL, 1000000000000000000LL
+	};
+	if (exponent <= 18) {
+		return powers[MAX(0, exponent)];
+	}
+	if (exponent <= 36) {
+		return (CHDecimalWide)powers[18] * powers[exponent - 18];
+	}
+	return (CHDecimalWide)powers[18] * powers[18] * powers[exponent - 36];
+}
+
+static int CHDecimalNumDigits(CHDecimalWide magnitude)
+{
+	int digits = 1;
+	while (magnitude >= 10) {
+		magnitude /= 10;
+		digits++;
+	}
+	return digits;
+}
+
+/**
+ *  Divides the number by 10^digits, rounding according to the rounding mode.
+ *  @param sticky YES if digits have been discarded before, meaning the number is a tiny bit larger (in magnitude) than it looks
+ */
+static CHDecimalWide CHDecimalShift(CHDecimalWide number, int digits, NSRoundingMode mode, BOOL sticky)
+{
+	if (digits <= 0) {
+		return number;
+	}
+
+	BOOL negative = (number < 0);
+	CHDecimalWide magnitude = negative ? -number : number;
+	CHDecimalWide quotient = 0;
+	BOOL aboveHalf = NO;
+	BOOL exactlyHalf = NO;
+	BOOL inexact = (0 != magnitude || sticky);
+
+	// 10^38 is the largest power of ten we can hold, the number is always smaller than half of anything larger
+	if (digits <= 38) {
+		CHDecimalWide divisor = CHDecimalPow10(digits);
+		CHDecimalWide half = divisor / 2;
+		CHDecimalWide remainder = magnitude % divisor;
+		quotient = magnitude / divisor;
+		aboveHalf = (remainder > half || (remainder == half && sticky));
+		exactlyHalf = (remainder == half && !sticky);
+		inexact = (0 != remainder || sticky);
+	}
+
+	BOOL awayFromZero = NO;
+	switch (mode) {
+		case NSRoundPlain:
+			awayFromZero = (aboveHalf || exactlyHalf);
+			break;
+		case NSRoundBankers:
+			awayFromZero = (aboveHalf || (exactlyHalf && (1 == quotient % 2)));
+			break;
+		case NSRoundDown:
+			awayFromZero = (negative && inexact);
+			break;
+		case NSRoundUp:
+			awayFromZero = (!negative && inexact);
+			break;
+	}
+	if (awayFromZero) {
+		quotient++;
+	}
+
+	return negative ? -quotient : quotient;
+}
+
+/**
+ *  Brings a wide mantissa and any scale into the range we can store, rounding with NSRoundPlain if needed.
+ */
+static CHDecimal CHDecimalNormalize(CHDecimalWide mantissa, int scale, BOOL sticky)
+{
+	// too many digits after the decimal point
+	if (scale > CHDecimalMaxScale) {
+		mantissa = CHDecimalShift(mantissa, scale - CHDecimalMaxScale, NSRoundPlain, sticky);
+		scale = CHDecimalMaxScale;
+		sticky = NO;
+	}
+
+	// mantissa too large, sacrifice precision
+	while (mantissa > kCHDecimalMantissaMax || mantissa < -kCHDecimalMantissaMax) {
+		CHDecimalWide magnitude = (mantissa < 0) ? -mantissa : mantissa;
+		int drop = CHDecimalNumDigits(magnitude) - 18;
+		mantissa = CHDecimalShift(mantissa, (drop > 0) ? drop : 1, NSRoundPlain, sticky);
+		scale -= (drop > 0) ? drop : 1;
+		sticky = NO;
+	}
+
+	// too many trailing zeros, move them into the mantissa
+	if (0 == mantissa) {
+		scale = MAX(0, MIN(scale, CHDecimalMaxScale));
+	}
+	while (scale < CHDecimalMinScale) {
+		mantissa *= 10;
+		scale++;
+		if (mantissa > kCHDecimalMantissaMax || mantissa < -kCHDecimalMantissaMax) {
+			return CHDecimalMakeInfinity(mantissa < 0);
+		}
+	}
+
+	CHDecimal decimal = {(int64_t)mantissa, (int16_t)scale, CHDecimalKindNumber};
+	return decimal;
+}
+
+/**
+ *  Handles the operands that are not plain numbers; returns YES if it did, with the result in "result".
+ */
+static BOOL CHDecimalHandleSpecial(CHDecimal a, CHDecimal b, CHDecimal *result)
+{
+	if (CHDecimalKindUndefined == a.kind || CHDecimalKindUndefined == b.kind) {
+		*result = CHDecimalMakeUndefined();
+		return YES;
+	}
+	if (CHDecimalKindNotANumber == a.kind || CHDecimalKindNotANumber == b.kind) {
+		*result = CHDecimalMakeNotANumber();
+		return YES;
+	}
+	return NO;
+}
+
+static int CHDecimalSign(CHDecimal decimal)
+{
+	if (CHDecimalKindPlusInfinity == decimal.kind) {
+		return 1;
+	}
+	if (CHDecimalKindMinusInfinity == decimal.kind) {
+		return -1;
+	}
+	return (decimal.mantissa > 0) ? 1 : ((decimal.mantissa < 0) ? -1 : 0);
+}
+
+
+
+#pragma mark - Creating
+CHDecimal CHDecimalMake(int64_t mantissa, int16_t scale)
+{
+	return CHDecimalNormalize(mantissa, scale, NO);
+}
+
+CHDecimal CHDecimalMakeUndefined(void)
+{
+	CHDecimal decimal = {0, 0, CHDecimalKindUndefined};
+	return decimal;
+}
+
+CHDecimal CHDecimalMakeNotANumber(void)
+{
+	CHDecimal decimal = {0, 0, CHDecimalKindNotANumber};
+	return decimal;
+}
+
+CHDecimal CHDecimalMakeInfinity(BOOL negative)
+{
+	CHDecimal decimal = {0, 0, (negative ? CHDecimalKindMinusInfinity : CHDecimalKindPlusInfinity)};
+	return decimal;
+}
+
+
+/**
+ *  Parses a number like "12", "-0.0254" or "1.5e3" from UTF-8 bytes, the same strings NSDecimalNumber's "decimalNumberWithString:" understands.
+ *
+ *  Leading whitespace is skipped, parsing stops at the first character that doesn't belong to the number. Returns NaN if there are no digits.
+ *  @param consumed If not NULL, will be set to the number of bytes that were parsed
+ */
+CHDecimal CHDecimalFromUTF8(const char *bytes, size_t length, size_t *consumed)
+{
+	size_t i = 0;
+	while (i < length && (' ' == bytes[i] || '\t' == bytes[i] || '\n' == bytes[i] || '\r' == bytes[i])) {
+		i++;
+	}
+
+	// sign
+	BOOL negative = NO;
+	if (i < length && ('-' == bytes[i] || '+' == bytes[i])) {
+		negative = ('-' == bytes[i]);
+		i++;
+	}
+
+	// digits; once the mantissa is full we only track the magnitude and whether we dropped non-zero digits
+	const CHDecimalWide limit = CHDecimalPow10(37);
+	CHDecimalWide mantissa = 0;
+	int scale = 0;
+	BOOL sticky = NO;
+	BOOL afterPoint = NO;
+	BOOL hasDigits = NO;
+	for (; i < length; i++) {
+		char c = bytes[i];
+		if ('.' == c && !afterPoint) {
+			afterPoint = YES;
+			continue;
+		}
+		if (c < '0' || c > '9') {
+			break;
+		}
+
+		hasDigits = YES;
+		if (mantissa < limit) {
+			mantissa = mantissa * 10 + (c - '0');
+			if (afterPoint) {
+				scale++;
+			}
+		}
+		else {
+			if (!afterPoint) {
+				scale--;
+			}
+			if ('0' != c) {
+				sticky = YES;
+			}
+		}
+	}
+
+	if (!hasDigits) {
+		if (NULL != consumed) {
+			*consumed = i;
+		}
+		return CHDecimalMakeNotANumber();
+	}
+
+	// exponent
+	if (i < length && ('e' == bytes[i] || 'E' == bytes[i])) {
+		size_t j = i + 1;
+		BOOL expNegative = NO;
+		if (j < length && ('-' == bytes[j] || '+' == bytes[j])) {
+			expNegative = ('-' == bytes[j]);
+			j++;
+		}
+		if (j < length && bytes[j] >= '0' && bytes[j] <= '9') {
+			int exponent = 0;
+			for (; j < length && bytes[j] >= '0' && bytes[j] <= '9'; j++) {
+				if (exponent < 10000) {
+					exponent = exponent * 10 + (bytes[j] - '0');
+				}
+			}
+			scale += expNegative ? exponent : -exponent;
+			i = j;
+		}
+	}
+
+	if (NULL != consumed) {
+		*consumed = i;
+	}
+	return CHDecimalNormalize(negative ? -mantissa : mantissa, scale, sticky);
+}
+
+/**
+ *  Parses the string like NSDecimalNumber's "decimalNumberWithString:" does; a nil string gives NaN, just like there.
+ */
+CHDecimal CHDecimalFromString(NSString *string)
+{
+	if (!string) {
+		return CHDecimalMakeNotANumber();
+	}
+
+	// avoid creating a C string copy for short strings
+	CFStringRef cfString = (__bridge CFStringRef)string;
+	const char *bytes = CFStringGetCStringPtr(cfString, kCFStringEncodingUTF8);
+	if (NULL != bytes) {
+		return CHDecimalFromUTF8(bytes, strlen(bytes), NULL);
+	}
+
+	char buffer[128];
+	if (CFStringGetCString(cfString, buffer, sizeof(buffer), kCFStringEncodingUTF8)) {
+		return CHDecimalFromUTF8(buffer, strlen(buffer), NULL);
+	}
+
+	bytes = [string UTF8String];
+	return CHDecimalFromUTF8(bytes, strlen(bytes), NULL);
+}
+
+/**
+ *  Creates a decimal from a double, rounded to the given number of digits after the decimal point (the same as formatting it with "%.<scale>f").
+ */
+CHDecimal CHDecimalFromDouble(double value, short scale)
+{
+	if (isnan(value)) {
+		return CHDecimalMakeNotANumber();
+	}
+	if (isinf(value)) {
+		return CHDecimalMakeInfinity(value < 0.0);
+	}
+
+	char buffer[384];
+	int length = snprintf(buffer, sizeof(buffer), "%.*f", (int)MAX(0, MIN(scale, CHDecimalMaxScale)), value);
+	if (length < 0 || length >= (int)sizeof(buffer)) {
+		return CHDecimalMakeInfinity(value < 0.0);
+	}
+	return CHDecimalFromUTF8(buffer, (size_t)length, NULL);
+}
+
+CHDecimal CHDecimalFromNSDecimal(NSDecimal decimal)
+{
+	if (0 == decimal._length) {
+		return decimal._isNegative ? CHDecimalMakeNotANumber() : CHDecimalMake(0, 0);
+	}
+
+	unsigned __int128 magnitude = 0;
+	for (int i = (int)decimal._length - 1; i >= 0; i--) {
+		magnitude = (magnitude << 16) | decimal._mantissa[i];
+	}
+
+	// the mantissa of NSDecimal can use all 128 bits, make room for the sign
+	int scale = -decimal._exponent;
+	BOOL sticky = NO;
+	if (magnitude > (unsigned __int128)CHDecimalPow10(38)) {
+		sticky = (0 != magnitude % 10);
+		magnitude /= 10;
+		scale--;
+	}
+	CHDecimalWide mantissa = (CHDecimalWide)magnitude;
+	return CHDecimalNormalize(decimal._isNegative ? -mantissa : mantissa, scale, sticky);
+}
+
+/**
+ *  NSDecimalNumber instances are converted exactly, other numbers via their string representation (which is what we used to do when reading JSON).
+ */
+CHDecimal CHDecimalFromNumber(NSNumber *number)
+{
+	if (!number) {
+		return CHDecimalMakeUndefined();
+	}
+	if ([number isKindOfClass:[NSDecimalNumber class]]) {
+		if ([number isEqual:[NSDecimalNumber maximumDecimalNumber]]) {
+			return CHDecimalMakeInfinity(NO);
+		}
+		if ([number isEqual:[NSDecimalNumber minimumDecimalNumber]]) {
+			return CHDecimalMakeInfinity(YES);
+		}
+		return CHDecimalFromNSDecimal([number decimalValue]);
+	}
+	return CHDecimalFromString([number description]);
+}
+
+
+
+#pragma mark - Converting
+/**
+ *  Prints the decimal into the buffer the way NSDecimalNumber's "description" does, i.e. without trailing zeros after the decimal point.
+ *  @return The length of the string, excluding the terminating NUL; 0 if the buffer was too small
+ */
+size_t CHDecimalPrint(CHDecimal decimal, char *buffer, size_t size)
+{
+	const char *special = NULL;
+	if (CHDecimalKindUndefined == decimal.kind) {
+		special = "";
+	}
+	else if (CHDecimalKindNotANumber == decimal.kind) {
+		special = "NaN";
+	}
+	else if (CHDecimalKindPlusInfinity == decimal.kind) {
+		special = "inf";
+	}
+	else if (CHDecimalKindMinusInfinity == decimal.kind) {
+		special = "-inf";
+	}
+	if (NULL != special) {
+		size_t length = strlen(special);
+		if (length >= size) {
+			return 0;
+		}
+		memcpy(buffer, special, length + 1);
+		return length;
+	}
+
+	// strip trailing zeros after the decimal point
+	int64_t mantissa = decimal.mantissa;
+	int scale = decimal.scale;
+	while (scale > 0 && 0 == mantissa % 10) {
+		mantissa /= 10;
+		scale--;
+	}
+
+	// digits, in reverse
+	char digits[24];
+	int numDigits = 0;
+	uint64_t magnitude = (mantissa < 0) ? (uint64_t)(-(mantissa + 1)) + 1 : (uint64_t)mantissa;
+	do {
+		digits[numDigits++] = (char)('0' + magnitude % 10);
+		magnitude /= 10;
+	} while (magnitude > 0);
+
+	// compose
+	size_t pos = 0;
+	size_t needed = (size_t)(MAX(numDigits, scale + 1) + 3 + MAX(0, -scale));
+	if (needed >= size) {
+		return 0;
+	}
+	if (mantissa < 0) {
+		buffer[pos++] = '-';
+	}
+	if (scale >= numDigits) {
+		buffer[pos++] = '0';
+		buffer[pos++] = '.';
+		for (int i = scale; i > numDigits; i--) {
+			buffer[pos++] = '0';
+		}
+		for (int i = numDigits - 1; i >= 0; i--) {
+			buffer[pos++] = digits[i];
+		}
+	}
+	else {
+		for (int i = numDigits - 1; i >= 0; i--) {
+			buffer[pos++] = digits[i];
+			if (i == scale && scale > 0) {
+				buffer[pos++] = '.';
+			}
+		}
+		for (int i = scale; i < 0; i++) {
+			buffer[pos++] = '0';
+		}
+	}
+	buffer[pos] = '\0';
+
+	return pos;
+}
+
+/**
+ *  @return The string representation, "inf" and "-inf" for infinities, nil if the decimal is undefined
+ */
+NSString *CHDecimalString(CHDecimal decimal)
+{
+	if (CHDecimalKindUndefined == decimal.kind) {
+		return nil;
+	}
+	char buffer[160];
+	size_t length = CHDecimalPrint(decimal, buffer, sizeof(buffer));
+	return [[NSString alloc] initWithBytes:buffer length:length encoding:NSUTF8StringEncoding];
+}
+
+/**
+ *  @return An NSDecimalNumber representing the decimal, nil if the decimal is undefined
+ */
+NSDecimalNumber *CHDecimalNumber(CHDecimal decimal)
+{
+	switch (decimal.kind) {
+		case CHDecimalKindUndefined:
+			return nil;
+		case CHDecimalKindNotANumber:
+			return [NSDecimalNumber notANumber];
+		case CHDecimalKindPlusInfinity:
+			return [NSDecimalNumber maximumDecimalNumber];
+		case CHDecimalKindMinusInfinity:
+			return [NSDecimalNumber minimumDecimalNumber];
+		case CHDecimalKindNumber:
+			break;
+	}
+
+	BOOL negative = (decimal.mantissa < 0);
+	unsigned long long magnitude = negative ? (unsigned long long)(-(decimal.mantissa + 1)) + 1 : (unsigned long long)decimal.mantissa;
+	return [NSDecimalNumber decimalNumberWithMantissa:magnitude exponent:(short)-decimal.scale isNegative:negative];
+}
+
+double CHDecimalDoubleValue(CHDecimal decimal)
+{
+	switch (decimal.kind) {
+		case CHDecimalKindUndefined:
+			return 0.0;
+		case CHDecimalKindNotANumber:
+			return NAN;
+		case CHDecimalKindPlusInfinity:
+			return INFINITY;
+		case CHDecimalKindMinusInfinity:
+			return -INFINITY;
+		case CHDecimalKindNumber:
+			break;
+	}
+
+	if (decimal.scale >= 0) {
+		return (double)decimal.mantissa / pow(10.0, decimal.scale);
+	}
+	return (double)decimal.mantissa * pow(10.0, -decimal.scale);
+}
+
+/**
+ *  @return The integer part of the decimal (truncated towards zero, like NSNumber's "integerValue")
+ */
+NSInteger CHDecimalIntegerValue(CHDecimal decimal)
+{
+	if (CHDecimalKindNumber != decimal.kind) {
+		return 0;
+	}
+
+	CHDecimalWide integer = decimal.mantissa;
+	if (decimal.scale > 18) {							// the mantissa has at most 19 digits, all of them behind the decimal point
+		return 0;
+	}
+	else if (decimal.scale > 0) {
+		integer /= CHDecimalPow10(decimal.scale);
+	}
+	else if (decimal.scale < -18 && 0 != integer) {
+		return (integer > 0) ? NSIntegerMax : NSIntegerMin;
+	}
+	else if (decimal.scale < 0) {
+		integer *= CHDecimalPow10(-decimal.scale);
+	}
+	if (integer > NSIntegerMax) {
+		return NSIntegerMax;
+	}
+	if (integer < NSIntegerMin) {
+		return NSIntegerMin;
+	}
+	return (NSInteger)integer;
+}
+
+
+
+#pragma mark - Testing
+BOOL CHDecimalIsDefined(CHDecimal decimal)
+{
+	return (CHDecimalKindUndefined != decimal.kind);
+}
+
+BOOL CHDecimalIsNumber(CHDecimal decimal)
+{
+	return (CHDecimalKindNumber == decimal.kind);
+}
+
+BOOL CHDecimalIsNotANumber(CHDecimal decimal)
+{
+	return (CHDecimalKindNotANumber == decimal.kind);
+}
+
+BOOL CHDecimalIsInfinite(CHDecimal decimal)
+{
+	return (CHDecimalKindPlusInfinity == decimal.kind || CHDecimalKindMinusInfinity == decimal.kind);
+}
+
+
+
+#pragma mark - Arithmetic
+/**
+ *  Undefined operands give an undefined result (like messaging nil), NaN gives NaN and infinities behave as expected.
+ */
+CHDecimal CHDecimalAdd(CHDecimal a, CHDecimal b)
+{
+	CHDecimal result;
+	if (CHDecimalHandleSpecial(a, b, &result)) {
+		return result;
+	}
+	if (CHDecimalIsInfinite(a) || CHDecimalIsInfinite(b)) {
+		if (CHDecimalIsInfinite(a) && CHDecimalIsInfinite(b) && a.kind != b.kind) {
+			return CHDecimalMakeNotANumber();
+		}
+		return CHDecimalIsInfinite(a) ? a : b;
+	}
+
+	// adding zero doesn't need the scales to line up, which they may not at all (zero has scale 0)
+	if (0 == a.mantissa) {
+		return b;
+	}
+	if (0 == b.mantissa) {
+		return a;
+	}
+
+	// make sure the scales are not too far apart, digits more than 19 places below the other operand's last digit don't survive anyway
+	if (a.scale > b.scale + 19) {
+		a = CHDecimalRound(a, b.scale + 19, NSRoundPlain);
+	}
+	else if (b.scale > a.scale + 19) {
+		b = CHDecimalRound(b, a.scale + 19, NSRoundPlain);
+	}
+
+	int scale = MAX(a.scale, b.scale);
+	CHDecimalWide sum = (CHDecimalWide)a.mantissa * CHDecimalPow10(scale - a.scale) + (CHDecimalWide)b.mantissa * CHDecimalPow10(scale - b.scale);
+	return CHDecimalNormalize(sum, scale, NO);
+}
+
+CHDecimal CHDecimalSubtract(CHDecimal a, CHDecimal b)
+{
+	return CHDecimalAdd(a, CHDecimalNegate(b));
+}
+
+CHDecimal CHDecimalMultiply(CHDecimal a, CHDecimal b)
+{
+	CHDecimal result;
+	if (CHDecimalHandleSpecial(a, b, &result)) {
+		return result;
+	}
+	if (CHDecimalIsInfinite(a) || CHDecimalIsInfinite(b)) {
+		int sign = CHDecimalSign(a) * CHDecimalSign(b);
+		return (0 == sign) ? CHDecimalMakeNotANumber() : CHDecimalMakeInfinity(sign < 0);
+	}
+
+	CHDecimalWide product = (CHDecimalWide)a.mantissa * (CHDecimalWide)b.mantissa;
+	return CHDecimalNormalize(product, a.scale + b.scale, NO);
+}
+
+/**
+ *  Divides a by b. Dividing by zero gives NaN instead of raising like NSDecimalNumber does; methods taking NSDecimalNumbers that used to raise
+ *  (PPRange's "divideBy:", CHUnit's conversion from base unit) check for zero and keep raising NSDecimalNumberDivideByZeroException.
+ */
+CHDecimal CHDecimalDivide(CHDecimal a, CHDecimal b)
+{
+	CHDecimal result;
+	if (CHDecimalHandleSpecial(a, b, &result)) {
+		return result;
+	}
+	if (CHDecimalIsInfinite(a)) {
+		int sign = CHDecimalSign(a) * CHDecimalSign(b);
+		return (CHDecimalIsInfinite(b) || 0 == sign) ? CHDecimalMakeNotANumber() : CHDecimalMakeInfinity(sign < 0);
+	}
+	if (CHDecimalIsInfinite(b)) {
+		return CHDecimalMake(0, 0);
+	}
+	if (0 == b.mantissa) {
+		return CHDecimalMakeNotANumber();
+	}
+	if (0 == a.mantissa) {
+		return CHDecimalMake(0, 0);
+	}
+
+	// scale the dividend up as far as we can so the quotient has enough significant digits
+	CHDecimalWide dividend = a.mantissa;
+	int shift = 37 - CHDecimalNumDigits((dividend < 0) ? -dividend : dividend);
+	dividend *= CHDecimalPow10(shift);
+
+	CHDecimalWide quotient = dividend / b.mantissa;
+	BOOL sticky = (0 != dividend % b.mantissa);
+	return CHDecimalNormalize(quotient, a.scale + shift - b.scale, sticky);
+}
+
+CHDecimal CHDecimalNegate(CHDecimal decimal)
+{
+	if (CHDecimalKindPlusInfinity == decimal.kind) {
+		return CHDecimalMakeInfinity(YES);
+	}
+	if (CHDecimalKindMinusInfinity == decimal.kind) {
+		return CHDecimalMakeInfinity(NO);
+	}
+	decimal.mantissa = -decimal.mantissa;				// our mantissa never is INT64_MIN
+	return decimal;
+}
+
+CHDecimal CHDecimalAbsolute(CHDecimal decimal)
+{
+	return (CHDecimalSign(decimal) < 0) ? CHDecimalNegate(decimal) : decimal;
+}
+
+/**
+ *  The remainder of a divided by b, with the quotient rounded down (NSRoundDown), like NSDecimalNumber's "moduloFor:" from our extension.
+ */
+CHDecimal CHDecimalModulo(CHDecimal a, CHDecimal b)
+{
+	CHDecimal quotient = CHDecimalRound(CHDecimalDivide(a, b), 0, NSRoundDown);
+	return CHDecimalSubtract(a, CHDecimalMultiply(quotient, b));
+}
+
+/**
+ *  Rounds to the given number of digits after the decimal point, with the same rounding modes NSDecimalNumberHandler uses.
+ */
+CHDecimal CHDecimalRound(CHDecimal decimal, short scale, NSRoundingMode mode)
+{
+	if (CHDecimalKindNumber != decimal.kind || decimal.scale <= scale) {
+		return decimal;
+	}
+
+	CHDecimalWide rounded = CHDecimalShift(decimal.mantissa, decimal.scale - scale, mode, NO);
+	return CHDecimalNormalize(rounded, scale, NO);
+}
+
+
+
+#pragma mark - Comparison
+static int CHDecimalOrderOfKind(CHDecimalKind kind)
+{
+	switch (kind) {
+		case CHDecimalKindUndefined:		return 0;
+		case CHDecimalKindNotANumber:		return 1;
+		case CHDecimalKindMinusInfinity:	return 2;
+		case CHDecimalKindNumber:			return 3;
+		case CHDecimalKindPlusInfinity:		return 4;
+	}
+	return 0;
+}
+
+/**
+ *  Compares two decimals exactly.
+ *
+ *  For ordering purposes undefined decimals are smaller than NaN, which is smaller than minus infinity.
+ */
+NSComparisonResult CHDecimalCompare(CHDecimal a, CHDecimal b)
+{
+	if (a.kind != b.kind) {
+		return (CHDecimalOrderOfKind(a.kind) < CHDecimalOrderOfKind(b.kind)) ? NSOrderedAscending : NSOrderedDescending;
+	}
+	if (CHDecimalKindNumber != a.kind) {
+		return NSOrderedSame;
+	}
+
+	// compare a * 10^diff to b (or the other way round) without overflowing: b = q * 10^diff + r
+	BOOL swapped = (a.scale > b.scale);
+	CHDecimal lower = swapped ? b : a;
+	CHDecimal higher = swapped ? a : b;
+	int diff = higher.scale - lower.scale;
+
+	int sign = 0;
+	if (diff > 38) {
+		sign = (0 != lower.mantissa) ? CHDecimalSign(lower) : -CHDecimalSign(higher);
+	}
+	else {
+		CHDecimalWide divisor = CHDecimalPow10(diff);
+		CHDecimalWide quotient = higher.mantissa / divisor;
+		CHDecimalWide remainder = higher.mantissa % divisor;
+		if (lower.mantissa != quotient) {
+			sign = (lower.mantissa > quotient) ? 1 : -1;
+		}
+		else {
+			sign = (remainder > 0) ? -1 : ((remainder < 0) ? 1 : 0);
+		}
+	}
+
+	if (swapped) {
+		sign = -sign;
+	}
+	return (sign < 0) ? NSOrderedAscending : ((sign > 0) ? NSOrderedDescending : NSOrderedSame);
+}
+
+/**
+ *  @return The greater of the two decimals, a if they are the same
+ */
+CHDecimal CHDecimalGreater(CHDecimal a, CHDecimal b)
+{
+	return (NSOrderedAscending == CHDecimalCompare(a, b)) ? b : a;
+}
+
+/**
+ *  @return The smaller of the two decimals, a if they are the same
+ */
+CHDecimal CHDecimalSmaller(CHDecimal a, CHDecimal b)
+{
+	return (NSOrderedDescending == CHDecimalCompare(a, b)) ? b : a;
+}
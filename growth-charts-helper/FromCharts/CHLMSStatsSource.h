@@ -0,0 +1,37 @@
+//
+//  CHLMSStatsSource.h
+//  Charts
+//
+//  Created by Pascal Pfiffner on 10/19/26.
+//  Copyright (c) 2026 Boston Children's Hospital. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import "CHStatsSource.h"
+
+
+/**
+ *  One row of an LMS table: the Box-Cox power, median and coefficient of variation at an age.
+ */
+typedef struct {
+	double age;
+	double L;
+	double M;
+	double S;
+} CHLMSRow;
+
+
+/**
+ *  A stats source evaluating LMS tables, the format WHO and CDC publish their growth references in.
+ *
+ *  Between the ages of a table, L, M and S are interpolated linearly; outside of them the source has no data.
+ */
+@interface CHLMSStatsSource : NSObject <CHStatsSource>
+
+- (instancetype)initWithAgeUnitPath:(NSString *)ageUnitPath;
+
+- (void)addTable:(const CHLMSRow *)rows count:(NSUInteger)count forDataType:(NSString *)dataType gender:(CHGender)gender unitPath:(NSString *)unitPath;
+
++ (instancetype)who2006Source;
+
+@end
@@ -0,0 +1,165 @@
+//
+//  CHLMSStatsSource.m
+//  Charts
+//
+//  Created by Pascal Pfiffner on 10/19/26.
+//  Copyright (c) 2026 Boston Children's Hospital. All rights reserved.
+//
+
+#import "CHLMSStatsSource.h"
+
+
+/**
+ *  WHO Child Growth Standards (2006), weight-for-age and length-for-age, at selected months from birth to 2 years.
+ */
+static const CHLMSRow kWHO2006WeightBoys[] = {
+	{ 0, 0.3487, 3.3464, 0.14602 }, { 3, 0.2303, 6.3762, 0.11727 }, { 6, 0.1257, 7.9340, 0.10958 }, { 12, 0.0644, 9.6479, 0.10925 }, { 24, -0.0137, 12.1515, 0.11426 }
+};
+static const CHLMSRow kWHO2006WeightGirls[] = {
+	{ 0, 0.3809, 3.2322, 0.14171 }, { 3, 0.1714, 5.8458, 0.12619 }, { 6, 0.0809, 7.2970, 0.12204 }, { 12, -0.0756, 8.9481, 0.12268 }, { 24, -0.2024, 11.4775, 0.12390 }
+};
+static const CHLMSRow kWHO2006LengthBoys[] = {
+	{ 0, 1, 49.8842, 0.03795 }, { 3, 1, 61.4292, 0.03328 }, { 6, 1, 67.6236, 0.03165 }, { 12, 1, 75.7488, 0.03137 }, { 24, 1, 87.1161, 0.03507 }
+};
+static const CHLMSRow kWHO2006LengthGirls[] = {
+	{ 0, 1, 49.1477, 0.03790 }, { 3, 1, 59.8029, 0.03544 }, { 6, 1, 65.7311, 0.03448 }, { 12, 1, 74.0150, 0.03328 }, { 24, 1, 85.7153, 0.03764 }
+};
+
+
+/**
+ *  The z-score of a percentile (0 to 100), using Acklam's rational approximation of the inverse normal distribution; relative error below 1.2e-9.
+ */
+static double CHLMSZScoreForPercentile(double percentile)
+{
+	double p = percentile / 100.0;
+	if (!(p > 0.0 && p < 1.0)) {
+		return NAN;
+	}
+	
+	static const double a[] = { -3.969683028665376e+01, 2.209460984245205e+02, -2.759285104469687e+02, 1.383577518672690e+02, -3.066479806614716e+01, 2.506628277459239e+00 };
+	static const double b[] = { -5.447609879822406e+01, 1.615858368580409e+02, -1.556989798598866e+02, 6.680131188771972e+01, -1.328068155288572e+01 };
+	static const double c[] = { -7.784894002430293e-03, -3.223964580411365e-01, -2.400758277161838e+00, -2.549732539343734e+00, 4.374664141464968e+00, 2.938163982698783e+00 };
+	static const double d[] = { 7.784695709041462e-03, 3.224671290700398e-01, 2.445134137142996e+00, 3.754408661907416e+00 };
+	static const double low = 0.02425;
+	
+	if (p < low) {
+		double q = sqrt(-2.0 * log(p));
+		return (((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) / ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1.0);
+	}
+	if (p > 1.0 - low) {
+		double q = sqrt(-2.0 * log(1.0 - p));
+		return -(((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) / ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1.0);
+	}
+	double q = p - 0.5;
+	double r = q * q;
+	return (((((a[0] * r + a[1]) * r + a[2]) * r + a[3]) * r + a[4]) * r + a[5]) * q / (((((b[0] * r + b[1]) * r + b[2]) * r + b[3]) * r + b[4]) * r + 1.0);
+}
+
+/**
+ *  Evaluates a table at an age, NAN outside of it. The rows must be sorted by age.
+ */
+static double CHLMSValue(const CHLMSRow *rows, NSUInteger count, double age, double z)
+{
+	if (count < 1 || !isfinite(z) || !(age >= rows[0].age && age <= rows[count - 1].age)) {
+		return NAN;
+	}
+	
+	NSUInteger i = 0;
+	while (i + 2 < count && age > rows[i + 1].age) {
+		i++;
+	}
+	double L = rows[i].L, M = rows[i].M, S = rows[i].S;
+	if (count > 1 && rows[i + 1].age > rows[i].age) {
+		double f = (age - rows[i].age) / (rows[i + 1].age - rows[i].age);
+		L += f * (rows[i + 1].L - L);
+		M += f * (rows[i + 1].M - M);
+		S += f * (rows[i + 1].S - S);
+	}
+	
+	if (fabs(L) < 1e-6) {
+		return M * exp(S * z);
+	}
+	double base = 1.0 + L * S * z;
+	return (base > 0.0) ? M * pow(base, 1.0 / L) : NAN;
+}
+
+
+@interface CHLMSStatsSource ()
+
+@property (nonatomic, copy) NSString *ageUnit;
+@property (nonatomic, strong) NSMutableDictionary *tables;				///< Data type -> gender (NSNumber) -> NSData of CHLMSRow; no string formatting, sources are asked for every curve point
+@property (nonatomic, strong) NSMutableDictionary *unitPaths;			///< Data type -> unit path
+
+@end
+
+
+@implementation CHLMSStatsSource
+
+
+- (instancetype)initWithAgeUnitPath:(NSString *)ageUnitPath
+{
+	if ((self = [super init])) {
+		self.ageUnit = ageUnitPath;
+		self.tables = [NSMutableDictionary new];
+		self.unitPaths = [NSMutableDictionary new];
+	}
+	return self;
+}
+
+/**
+ *  The bundled WHO 2006 weight- and length-for-age reference, registered with CHChartArea as "WHO.2006" for the bundled WHO charts.
+ */
++ (instancetype)who2006Source
+{
+	CHLMSStatsSource *source = [[self alloc] initWithAgeUnitPath:@"age.month"];
+	[source addTable:kWHO2006WeightBoys count:sizeof(kWHO2006WeightBoys) / sizeof(CHLMSRow) forDataType:@"bodyweight" gender:CHGenderMale unitPath:@"weight.kilogram"];
+	[source addTable:kWHO2006WeightGirls count:sizeof(kWHO2006WeightGirls) / sizeof(CHLMSRow) forDataType:@"bodyweight" gender:CHGenderFemale unitPath:@"weight.kilogram"];
+	[source addTable:kWHO2006LengthBoys count:sizeof(kWHO2006LengthBoys) / sizeof(CHLMSRow) forDataType:@"bodylength" gender:CHGenderMale unitPath:@"length.centimeter"];
+	[source addTable:kWHO2006LengthGirls count:sizeof(kWHO2006LengthGirls) / sizeof(CHLMSRow) forDataType:@"bodylength" gender:CHGenderFemale unitPath:@"length.centimeter"];
+	return source;
+}
+
+/**
+ *  Adds the table for a data type and gender; rows are copied and must be sorted by age, in the source's age unit.
+ *  Not thread safe, add all tables before registering the source.
+ */
+- (void)addTable:(const CHLMSRow *)rows count:(NSUInteger)count forDataType:(NSString *)dataType gender:(CHGender)gender unitPath:(NSString *)unitPath
+{
+	if (!dataType || count < 1) {
+		return;
+	}
+	NSMutableDictionary *byGender = _tables[dataType];
+	if (!byGender) {
+		byGender = [NSMutableDictionary new];
+		_tables[dataType] = byGender;
+	}
+	byGender[@(gender)] = [NSData dataWithBytes:rows length:count * sizeof(CHLMSRow)];
+	if (unitPath) {
+		_unitPaths[dataType] = unitPath;
+	}
+}
+
+
+
+#pragma mark - CHStatsSource
+- (NSString *)ageUnitPath
+{
+	return _ageUnit;
+}
+
+- (NSString *)unitPathForDataType:(NSString *)dataType
+{
+	return dataType ? _unitPaths[dataType] : nil;
+}
+
+- (double)valueForDataType:(NSString *)dataType gender:(CHGender)gender percentile:(double)percentile atAge:(double)age
+{
+	NSData *table = dataType ? _tables[dataType][@(gender)] : nil;
+	if (!table) {
+		return NAN;
+	}
+	return CHLMSValue([table bytes], [table length] / sizeof(CHLMSRow), age, CHLMSZScoreForPercentile(percentile));
+}
+
+
+@end
@@ -0,0 +1,83 @@
+//
+//  CHMeasurementIngest.h
+//  Charts
+//
+//  Created by Pascal Pfiffner on 10/19/26.
+//  Copyright (c) 2026 Boston Children's Hospital. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import "CHDecimal.h"
+#import "CHStringTable.h"
+
+@class CHUnit;
+
+
+#define CHMeasurementBatchCapacity 4096				///< The number of rows in a full batch
+
+
+typedef uint32_t CHPatientID;						///< Index of a patient in the ingest's "patients" plus 1, 0 is no patient; exports easily have more patients than CHStringID can count
+
+#define CHPatientIDNone 0
+
+
+/**
+ *  What went wrong with a row, if anything.
+ */
+typedef NS_ENUM(uint8_t, CHMeasurementStatus) {
+	CHMeasurementStatusOK = 0,
+	CHMeasurementStatusUnknownDataType,				///< The data type has no units we know about
+	CHMeasurementStatusUnknownUnit,					///< The unit is neither a unit path nor a label of the data type's units
+	CHMeasurementStatusInvalidValue,				///< The value is not a number
+	CHMeasurementStatusInvalidDate,					///< The date is not an ISO 8601 date or there is no birth date to compute the age from
+	CHMeasurementStatusTruncated					///< A field was missing
+};
+
+
+/**
+ *  A fixed-size batch of measurements, stored in columns.
+ *
+ *  Values are in the base unit of their data type's dimension, ages in seconds ("age.second", the age base unit). Rows that failed to parse stay in the
+ *  batch with a status other than CHMeasurementStatusOK so validation can report them by line.
+ */
+@interface CHMeasurementBatch : NSObject
+
+@property (nonatomic, readonly) NSUInteger count;				///< The number of rows in the batch, at most CHMeasurementBatchCapacity
+
+@property (nonatomic, readonly) const NSUInteger *lines;		///< The line number of each row in the input, starting at 1
+@property (nonatomic, readonly) const CHMeasurementStatus *statuses;
+@property (nonatomic, readonly) const CHPatientID *patients;		///< The patient, see the ingest's "patientForID:"
+@property (nonatomic, readonly) const CHStringID *dataTypes;	///< The data type, interned in the shared "dataType" table
+@property (nonatomic, readonly) const CHStringID *units;		///< The base unit path the value is in, interned in the shared "unit" table
+@property (nonatomic, readonly) const CHDecimal *values;		///< The value in base unit
+@property (nonatomic, readonly) const CHDecimal *ages;			///< The age in seconds at the time of measurement
+@property (nonatomic, readonly) const int8_t *plausibility;		///< 0 is plausible, -1 too low and 1 too high, like "checkPlausibilityOfDecimal:"
+
+@end
+
+
+/**
+ *  Reads measurements from CSV or NDJSON exports in batches.
+ *
+ *  The file is memory mapped and fields are parsed in place, rows don't allocate any objects. Each distinct data type and unit pair is resolved against
+ *  the unit definitions only once, and ISO 8601 dates are parsed by hand instead of going through NSCalendar.
+ *
+ *  CSV files need a header row naming the columns "patient", "date", "datatype", "value", "unit" and, optionally, "birthdate"; NDJSON files have one
+ *  flat object with these keys per line. Quoted CSV fields may contain commas, newlines and doubled quotes. Units can be given as path
+ *  ("weight.kilogram") or as label ("kg"). Rows without a birth date use "birthDate".
+ */
+@interface CHMeasurementIngest : NSObject
+
+@property (nonatomic, readonly, copy) NSURL *url;
+@property (nonatomic, strong) NSDate *birthDate;				///< The birth date to use for rows that don't have their own
+@property (nonatomic, strong) NSTimeZone *timeZone;				///< The time zone of dates without offset, the default time zone by default. Its offset is looked up per date, so daylight saving time is honored.
+@property (nonatomic, readonly) NSUInteger numPatients;			///< The number of distinct patients read so far
+@property (nonatomic, readonly) NSUInteger numRows;				///< The number of rows read so far
+@property (nonatomic, readonly) NSUInteger numRejected;			///< The number of rows read so far with a status other than OK
+
+- (instancetype)initWithURL:(NSURL *)url;
+
+- (BOOL)enumerateBatchesUsingBlock:(void (^)(CHMeasurementBatch *batch, BOOL *stop))block error:(NSError **)error;
+- (NSString *)patientForID:(CHPatientID)patientID;
+
+@end
@@ -0,0 +1,900 @@
+//
+//  CHMeasurementIngest.m
+//  Charts
+//
+//  Created by Pascal Pfiffner on 10/19/26.
+//  Copyright (c) 2026 Boston Children's Hospital. All rights reserved.
+//
+
+#import "CHMeasurementIngest.h"
+#import "CHUnit.h"
+
+
+/**
+ *  The fields of a row we care about, in the order we store them.
+ */
+typedef NS_ENUM(NSInteger, CHIngestField) {
+	CHIngestFieldNone = -1,
+	CHIngestFieldPatient = 0,
+	CHIngestFieldDate,
+	CHIngestFieldDataType,
+	CHIngestFieldValue,
+	CHIngestFieldUnit,
+	CHIngestFieldBirthDate,
+	CHIngestFieldCount
+};
+
+#define CHIngestMaxCSVColumns 64
+
+
+/**
+ *  A field of the current row, pointing into the mapped file.
+ */
+typedef struct {
+	const char *bytes;
+	size_t length;
+} CHIngestSpan;
+
+
+/**
+ *  A data type and unit combination resolved against the unit definitions.
+ */
+typedef struct {
+	char *key;								///< "<data type>\0<unit>", malloc'ed
+	size_t keyLength;
+	CHMeasurementStatus status;				///< OK or why the pair can't be used
+	CHStringID dataType;
+	CHStringID baseUnit;
+	BOOL isBase;
+	CHDecimal multiplier;					///< To convert to the base unit
+	CHDecimal plausibleMin;					///< In base unit
+	CHDecimal plausibleMax;					///< In base unit
+} CHIngestUnitEntry;
+
+
+
+#pragma mark - Parsing
+static CHIngestSpan CHIngestTrim(CHIngestSpan span)
+{
+	while (span.length > 0 && (' ' == span.bytes[0] || '\t' == span.bytes[0])) {
+		span.bytes++;
+		span.length--;
+	}
+	while (span.length > 0 && (' ' == span.bytes[span.length - 1] || '\t' == span.bytes[span.length - 1] || '\r' == span.bytes[span.length - 1])) {
+		span.length--;
+	}
+	return span;
+}
+
+/**
+ *  Maps a CSV column or JSON key name to the field we store it in.
+ */
+static CHIngestField CHIngestFieldForName(CHIngestSpan name)
+{
+	static const char *names[] = { "patient", "date", "datatype", "value", "unit", "birthdate" };
+	for (NSInteger i = 0; i < CHIngestFieldCount; i++) {
+		if (strlen(names[i]) == name.length && 0 == strncasecmp(names[i], name.bytes, name.length)) {
+			return (CHIngestField)i;
+		}
+	}
+	return CHIngestFieldNone;
+}
+
+/**
+ *  Reads fixed width digits, returns -1 if there aren't enough.
+ */
+static int CHIngestDigits(const char *bytes, size_t length, size_t at, size_t count)
+{
+	if (at + count > length) {
+		return -1;
+	}
+	int value = 0;
+	for (size_t i = at; i < at + count; i++) {
+		if (bytes[i] < '0' || bytes[i] > '9') {
+			return -1;
+		}
+		value = value * 10 + (bytes[i] - '0');
+	}
+	return value;
+}
+
+/**
+ *  Days since 1970-01-01 in the proleptic Gregorian calendar.
+ */
+static int64_t CHIngestDaysFromCivil(int64_t year, int64_t month, int64_t day)
+{
+	year -= (month <= 2);
+	int64_t era = (year >= 0 ? year : year - 399) / 400;
+	int64_t yearOfEra = year - era * 400;
+	int64_t dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+	int64_t dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+	return era * 146097 + dayOfEra - 719468;
+}
+
+static int CHIngestDaysInMonth(int year, int month)
+{
+	static const int days[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+	BOOL leap = (0 == year % 4 && 0 != year % 100) || 0 == year % 400;
+	return (2 == month && leap) ? 29 : days[month - 1];
+}
+
+/**
+ *  Parses "YYYY-MM-DD", optionally followed by "THH:MM[:SS[.fff]]" and "Z" or "+HH:MM". Days past the end of the month are rejected, and hour 24
+ *  only as "24:00:00", meaning the end of the day.
+ *  @param seconds Set to the seconds since 1970, UTC if the date had an offset and local time otherwise
+ *  @param hasOffset Set to YES if the date had an offset
+ *  @return NO if the date could not be parsed
+ */
+static BOOL CHIngestParseDate(CHIngestSpan span, int64_t *seconds, BOOL *hasOffset)
+{
+	const char *b = span.bytes;
+	size_t len = span.length;
+	if (len < 10) {											// we read the fixed offsets of "YYYY-MM-DD" below
+		return NO;
+	}
+	int year = CHIngestDigits(b, len, 0, 4);
+	int month = CHIngestDigits(b, len, 5, 2);
+	int day = CHIngestDigits(b, len, 8, 2);
+	if (year < 0 || month < 1 || month > 12 || '-' != b[4] || '-' != b[7]) {
+		return NO;
+	}
+	if (day < 1 || day > CHIngestDaysInMonth(year, month)) {
+		return NO;
+	}
+
+	int64_t result = CHIngestDaysFromCivil(year, month, day) * 86400;
+	size_t i = 10;
+	*hasOffset = NO;
+
+	// time
+	if (i < len && ('T' == b[i] || ' ' == b[i])) {
+		int hour = CHIngestDigits(b, len, i + 1, 2);
+		int minute = CHIngestDigits(b, len, i + 4, 2);
+		if (hour < 0 || hour > 24 || minute < 0 || minute > 59 || ':' != b[i + 3]) {
+			return NO;
+		}
+		result += hour * 3600 + minute * 60;
+		i += 6;
+
+		BOOL isMidnight = (0 == minute);
+		if (i < len && ':' == b[i]) {
+			int second = CHIngestDigits(b, len, i + 1, 2);
+			if (second < 0 || second > 60) {
+				return NO;
+			}
+			result += second;
+			isMidnight = isMidnight && (0 == second);
+			i += 3;
+			if (i < len && '.' == b[i]) {						// fractions don't matter for ages, but "24:00:00.5" is not a time
+				i++;
+				while (i < len && b[i] >= '0' && b[i] <= '9') {
+					isMidnight = isMidnight && ('0' == b[i]);
+					i++;
+				}
+			}
+		}
+		if (24 == hour && !isMidnight) {
+			return NO;
+		}
+
+		// offset
+		if (i < len && 'Z' == b[i]) {
+			*hasOffset = YES;
+			i++;
+		}
+		else if (i < len && ('+' == b[i] || '-' == b[i])) {
+			int sign = ('-' == b[i]) ? -1 : 1;
+			int offHour = CHIngestDigits(b, len, i + 1, 2);
+			size_t minuteAt = (i + 3 < len && ':' == b[i + 3]) ? i + 4 : i + 3;
+			int offMinute = CHIngestDigits(b, len, minuteAt, 2);
+			if (offHour < 0 || offHour > 23 || offMinute < 0 || offMinute > 59) {
+				return NO;
+			}
+			result -= sign * (offHour * 3600 + offMinute * 60);
+			*hasOffset = YES;
+			i = minuteAt + 2;
+		}
+	}
+
+	if (i != len) {
+		return NO;
+	}
+	*seconds = result;
+	return YES;
+}
+
+/**
+ *  Finds the end of the CSV record starting at "bytes": the first newline that isn't inside a quoted field. Quotes only start a quoted field at the
+ *  beginning of a field, like in "CHIngestSplitCSV()".
+ *  @param newlines Set to the number of newlines inside quoted fields, so line numbers stay right
+ */
+static const char *CHIngestCSVRecordEnd(const char *bytes, const char *end, NSUInteger *newlines)
+{
+	*newlines = 0;
+	const char *eol = memchr(bytes, '\n', end - bytes);
+	eol = eol ? eol : end;
+	if (!memchr(bytes, '"', eol - bytes)) {					// the usual case
+		return eol;
+	}
+
+	BOOL quoted = NO;
+	BOOL atFieldStart = YES;
+	for (const char *c = bytes; c < end; c++) {
+		if (quoted) {
+			if ('"' == *c) {
+				if (c + 1 < end && '"' == c[1]) {
+					c++;
+				}
+				else {
+					quoted = NO;
+				}
+			}
+			else if ('\n' == *c) {
+				(*newlines)++;
+			}
+			continue;
+		}
+		if ('\n' == *c) {
+			return c;
+		}
+		if ('"' == *c && atFieldStart) {
+			quoted = YES;
+		}
+		atFieldStart = (',' == *c) || (atFieldStart && (' ' == *c || '\t' == *c));
+	}
+	return end;
+}
+
+/**
+ *  Splits a CSV record into fields; quoted fields are returned without their quotes. Quoted fields with doubled quotes are unescaped into "scratch",
+ *  which must hold at least "length" bytes, all other fields point into "bytes".
+ *  @return The number of fields found, at most "max"
+ */
+static NSUInteger CHIngestSplitCSV(const char *bytes, size_t length, CHIngestSpan *fields, NSUInteger max, char *scratch)
+{
+	NSUInteger count = 0;
+	size_t i = 0;
+	size_t scratchUsed = 0;
+	while (count < max) {
+		while (i < length && (' ' == bytes[i] || '\t' == bytes[i])) {
+			i++;
+		}
+		CHIngestSpan field = { bytes + i, 0 };
+		if (i < length && '"' == bytes[i]) {
+			size_t start = ++i;
+			BOOL hasDoubledQuotes = NO;
+			while (i < length) {
+				if ('"' == bytes[i]) {
+					if (i + 1 >= length || '"' != bytes[i + 1]) {
+						break;
+					}
+					hasDoubledQuotes = YES;
+					i++;
+				}
+				i++;
+			}
+			field.bytes = bytes + start;
+			field.length = MIN(i, length) - start;
+			if (hasDoubledQuotes) {
+				char *unescaped = scratch + scratchUsed;
+				size_t n = 0;
+				for (size_t j = 0; j < field.length; j++) {
+					unescaped[n++] = field.bytes[j];
+					if ('"' == field.bytes[j]) {				// all quotes in here are doubled
+						j++;
+					}
+				}
+				field.bytes = unescaped;
+				field.length = n;
+				scratchUsed += n;
+			}
+			while (i < length && ',' != bytes[i]) {
+				i++;
+			}
+		}
+		else {
+			size_t start = i;
+			while (i < length && ',' != bytes[i]) {
+				i++;
+			}
+			field.length = i - start;
+		}
+		fields[count++] = CHIngestTrim(field);
+
+		if (i >= length) {
+			break;
+		}
+		i++;										// skip the comma
+	}
+	return count;
+}
+
+/**
+ *  Reads the keys of a flat JSON object into the fields; strings keep their escapes, which our fields don't use.
+ *  @return NO if the line is not an object
+ */
+static BOOL CHIngestSplitJSON(const char *bytes, size_t length, CHIngestSpan *fields)
+{
+	size_t i = 0;
+	while (i < length && '{' != bytes[i]) {
+		if (' ' != bytes[i] && '\t' != bytes[i]) {
+			return NO;
+		}
+		i++;
+	}
+	i++;
+
+	while (i < length) {
+		while (i < length && '"' != bytes[i] && '}' != bytes[i]) {
+			i++;
+		}
+		if (i >= length || '}' == bytes[i]) {
+			break;
+		}
+
+		// key
+		CHIngestSpan key = { bytes + (++i), 0 };
+		while (i < length && '"' != bytes[i]) {
+			i++;
+		}
+		key.length = (bytes + i) - key.bytes;
+		i++;
+		while (i < length && (' ' == bytes[i] || '\t' == bytes[i] || ':' == bytes[i])) {
+			i++;
+		}
+
+		// value
+		CHIngestSpan value = { bytes + i, 0 };
+		if (i < length && '"' == bytes[i]) {
+			value.bytes = bytes + (++i);
+			while (i < length && '"' != bytes[i]) {
+				i += ('\\' == bytes[i]) ? 2 : 1;
+			}
+			value.length = MIN(i, length) - (value.bytes - bytes);
+			i++;
+		}
+		else {
+			while (i < length && ',' != bytes[i] && '}' != bytes[i]) {
+				i++;
+			}
+			value.length = (bytes + i) - value.bytes;
+			value = CHIngestTrim(value);
+			if (4 == value.length && 0 == strncmp("null", value.bytes, 4)) {
+				value.length = 0;
+			}
+		}
+
+		CHIngestField field = CHIngestFieldForName(key);
+		if (CHIngestFieldNone != field) {
+			fields[field] = value;
+		}
+	}
+	return YES;
+}
+
+
+
+#pragma mark - Batch
+@interface CHMeasurementBatch () {
+	@package
+	NSUInteger _count;
+	NSUInteger *_lines;
+	CHMeasurementStatus *_statuses;
+	CHPatientID *_patients;
+	CHStringID *_dataTypes;
+	CHStringID *_units;
+	CHDecimal *_values;
+	CHDecimal *_ages;
+	int8_t *_plausibility;
+}
+
+@end
+
+
+@implementation CHMeasurementBatch
+
+
+- (instancetype)init
+{
+	if ((self = [super init])) {
+		_lines = calloc(CHMeasurementBatchCapacity, sizeof(NSUInteger));
+		_statuses = calloc(CHMeasurementBatchCapacity, sizeof(CHMeasurementStatus));
+		_patients = calloc(CHMeasurementBatchCapacity, sizeof(CHPatientID));
+		_dataTypes = calloc(CHMeasurementBatchCapacity, sizeof(CHStringID));
+		_units = calloc(CHMeasurementBatchCapacity, sizeof(CHStringID));
+		_values = calloc(CHMeasurementBatchCapacity, sizeof(CHDecimal));
+		_ages = calloc(CHMeasurementBatchCapacity, sizeof(CHDecimal));
+		_plausibility = calloc(CHMeasurementBatchCapacity, sizeof(int8_t));
+	}
+	return self;
+}
+
+- (void)dealloc
+{
+	free(_lines);
+	free(_statuses);
+	free(_patients);
+	free(_dataTypes);
+	free(_units);
+	free(_values);
+	free(_ages);
+	free(_plausibility);
+}
+
+
+- (NSUInteger)count { return _count; }
+- (const NSUInteger *)lines { return _lines; }
+- (const CHMeasurementStatus *)statuses { return _statuses; }
+- (const CHPatientID *)patients { return _patients; }
+- (const CHStringID *)dataTypes { return _dataTypes; }
+- (const CHStringID *)units { return _units; }
+- (const CHDecimal *)values { return _values; }
+- (const CHDecimal *)ages { return _ages; }
+- (const int8_t *)plausibility { return _plausibility; }
+
+
+@end
+
+
+
+#pragma mark - Ingest
+@interface CHMeasurementIngest () {
+	CHIngestUnitEntry *unitEntries;
+	NSUInteger numUnitEntries;
+	NSUInteger lastUnitEntry;
+
+	CHIngestSpan lastPatient;					///< Exports are usually sorted by patient, so we only intern when it changes. Points to "lastPatientBytes".
+	CHPatientID lastPatientID;
+	char *lastPatientBytes;
+	size_t lastPatientCapacity;
+
+	char *scratch;								///< Unescaped CSV fields of the current record
+	size_t scratchCapacity;
+
+	int64_t defaultBirthSeconds;
+	BOOL hasDefaultBirthDate;
+
+	NSTimeZone *zone;							///< "timeZone" or the default time zone, for the current enumeration
+	int64_t *zoneStarts;						///< Seconds since 1970 (UTC) from which the offset at the same index applies, ascending
+	int32_t *zoneOffsets;
+	NSUInteger numZoneEntries;
+	int64_t zoneFrom;							///< The range covered by the table, in seconds since 1970 (UTC)
+	int64_t zoneTo;
+}
+
+@property (nonatomic, readwrite, copy) NSURL *url;
+@property (nonatomic, strong) NSMutableArray *patients;				///< Patient strings, the patient with ID n is at index n - 1
+@property (nonatomic, strong) NSMutableDictionary *patientIDs;			///< Patient string -> ID (as NSNumber)
+@property (nonatomic, readwrite) NSUInteger numRows;
+@property (nonatomic, readwrite) NSUInteger numRejected;
+
+@end
+
+
+@implementation CHMeasurementIngest
+
+
+- (instancetype)initWithURL:(NSURL *)url
+{
+	if ((self = [super init])) {
+		self.url = url;
+		self.patients = [NSMutableArray new];
+		self.patientIDs = [NSMutableDictionary new];
+	}
+	return self;
+}
+
+- (void)dealloc
+{
+	for (NSUInteger i = 0; i < numUnitEntries; i++) {
+		free(unitEntries[i].key);
+	}
+	free(unitEntries);
+	free(lastPatientBytes);
+	free(scratch);
+	free(zoneStarts);
+	free(zoneOffsets);
+}
+
+
+
+#pragma mark - Reading
+/**
+ *  Maps the file and calls the block with every full batch and with the last, partial one. The batch object is reused, copy what you need to keep.
+ *  @return NO if the file could not be read
+ */
+- (BOOL)enumerateBatchesUsingBlock:(void (^)(CHMeasurementBatch *batch, BOOL *stop))block error:(NSError **)error
+{
+	NSData *data = [NSData dataWithContentsOfURL:_url options:NSDataReadingMappedAlways error:error];
+	if (!data) {
+		return NO;
+	}
+
+	// resolve the birth date once; the time zone's offsets are looked up as dates come in
+	zone = _timeZone ? _timeZone : [NSTimeZone defaultTimeZone];
+	numZoneEntries = 0;
+	hasDefaultBirthDate = (nil != _birthDate);
+	defaultBirthSeconds = hasDefaultBirthDate ? (int64_t)floor([_birthDate timeIntervalSince1970]) : 0;
+	lastPatient = (CHIngestSpan){ NULL, 0 };
+	lastPatientID = CHPatientIDNone;
+
+	const char *bytes = [data bytes];
+	const char *end = bytes + [data length];
+	const char *line = bytes;
+	NSUInteger lineNumber = 0;
+
+	// skip a UTF-8 BOM and blank lines, then see whether we got CSV or NDJSON
+	if (end - line >= 3 && 0 == memcmp(line, "\xEF\xBB\xBF", 3)) {
+		line += 3;
+	}
+	while (line < end && ('\n' == *line || '\r' == *line || ' ' == *line)) {
+		if ('\n' == *line) {
+			lineNumber++;
+		}
+		line++;
+	}
+	BOOL isJSON = (line < end && '{' == *line);
+
+	CHIngestField columns[CHIngestMaxCSVColumns];
+	NSUInteger numColumns = 0;
+	if (!isJSON && line < end) {
+		NSUInteger newlines = 0;
+		const char *eol = CHIngestCSVRecordEnd(line, end, &newlines);
+		CHIngestSpan header[CHIngestMaxCSVColumns];
+		numColumns = CHIngestSplitCSV(line, eol - line, header, CHIngestMaxCSVColumns, [self scratchOfLength:eol - line]);
+		for (NSUInteger i = 0; i < numColumns; i++) {
+			columns[i] = CHIngestFieldForName(header[i]);
+		}
+		line = eol + 1;
+		lineNumber += 1 + newlines;
+	}
+
+	CHMeasurementBatch *batch = [CHMeasurementBatch new];
+	BOOL stop = NO;
+	while (line < end && !stop) {
+		@autoreleasepool {
+			while (line < end && batch->_count < CHMeasurementBatchCapacity) {
+				NSUInteger newlines = 0;
+				const char *eol = isJSON ? memchr(line, '\n', end - line) : CHIngestCSVRecordEnd(line, end, &newlines);
+				eol = eol ? eol : end;
+				lineNumber++;
+				NSUInteger recordLine = lineNumber;					// rows are reported by the line they start on
+				lineNumber += newlines;
+
+				CHIngestSpan fields[CHIngestFieldCount];
+				memset(fields, 0, sizeof(fields));
+				CHIngestSpan span = CHIngestTrim((CHIngestSpan){ line, eol - line });
+				line = eol + 1;
+				if (0 == span.length) {
+					continue;
+				}
+
+				BOOL ok = YES;
+				if (isJSON) {
+					ok = CHIngestSplitJSON(span.bytes, span.length, fields);
+				}
+				else {
+					CHIngestSpan row[CHIngestMaxCSVColumns];
+					NSUInteger numFields = CHIngestSplitCSV(span.bytes, span.length, row, numColumns, [self scratchOfLength:span.length]);
+					for (NSUInteger i = 0; i < numFields; i++) {
+						if (CHIngestFieldNone != columns[i]) {
+							fields[columns[i]] = row[i];
+						}
+					}
+				}
+
+				[self readRow:fields ok:ok line:recordLine into:batch];
+			}
+
+			if (batch->_count > 0) {
+				block(batch, &stop);
+				batch->_count = 0;
+			}
+		}
+	}
+
+	return YES;
+}
+
+/**
+ *  The buffer CSV fields are unescaped into, grown as needed and reused for all records.
+ */
+- (char *)scratchOfLength:(size_t)length
+{
+	if (length > scratchCapacity) {
+		scratchCapacity = MAX(length, 2 * scratchCapacity);
+		scratch = reallocf(scratch, scratchCapacity);
+	}
+	return scratch;
+}
+
+/**
+ *  Parses the fields of one row into the next slot of the batch.
+ */
+- (void)readRow:(CHIngestSpan *)fields ok:(BOOL)ok line:(NSUInteger)line into:(CHMeasurementBatch *)batch
+{
+	NSUInteger idx = batch->_count++;
+	batch->_lines[idx] = line;
+	batch->_patients[idx] = CHPatientIDNone;
+	batch->_dataTypes[idx] = CHStringIDNone;
+	batch->_units[idx] = CHStringIDNone;
+	batch->_values[idx] = CHDecimalMakeUndefined();
+	batch->_ages[idx] = CHDecimalMakeUndefined();
+	batch->_plausibility[idx] = 0;
+	_numRows++;
+
+	CHMeasurementStatus status = [self parseRow:fields ok:ok atIndex:idx into:batch];
+	batch->_statuses[idx] = status;
+	if (CHMeasurementStatusOK != status) {
+		_numRejected++;
+	}
+}
+
+- (CHMeasurementStatus)parseRow:(CHIngestSpan *)fields ok:(BOOL)ok atIndex:(NSUInteger)idx into:(CHMeasurementBatch *)batch
+{
+	if (!ok || 0 == fields[CHIngestFieldDataType].length || 0 == fields[CHIngestFieldValue].length || 0 == fields[CHIngestFieldDate].length) {
+		return CHMeasurementStatusTruncated;
+	}
+	batch->_patients[idx] = [self idForPatient:fields[CHIngestFieldPatient]];
+
+	// data type and unit
+	CHIngestUnitEntry *entry = [self unitEntryForDataType:fields[CHIngestFieldDataType] unit:fields[CHIngestFieldUnit]];
+	batch->_dataTypes[idx] = entry->dataType;
+	if (CHMeasurementStatusOK != entry->status) {
+		return entry->status;
+	}
+	batch->_units[idx] = entry->baseUnit;
+
+	// value, normalized to base unit
+	CHIngestSpan valueSpan = fields[CHIngestFieldValue];
+	size_t consumed = 0;
+	CHDecimal value = CHDecimalFromUTF8(valueSpan.bytes, valueSpan.length, &consumed);
+	if (consumed != valueSpan.length || !CHDecimalIsNumber(value)) {
+		return CHMeasurementStatusInvalidValue;
+	}
+	value = entry->isBase ? value : CHDecimalMultiply(value, entry->multiplier);
+	batch->_values[idx] = value;
+
+	if (CHDecimalIsDefined(entry->plausibleMin) && NSOrderedAscending == CHDecimalCompare(value, entry->plausibleMin)) {
+		batch->_plausibility[idx] = -1;
+	}
+	else if (CHDecimalIsDefined(entry->plausibleMax) && NSOrderedDescending == CHDecimalCompare(value, entry->plausibleMax)) {
+		batch->_plausibility[idx] = 1;
+	}
+
+	// age
+	int64_t date = 0;
+	BOOL hasOffset = NO;
+	if (!CHIngestParseDate(fields[CHIngestFieldDate], &date, &hasOffset)) {
+		return CHMeasurementStatusInvalidDate;
+	}
+	if (!hasOffset) {
+		date -= [self offsetForLocalSeconds:date];
+	}
+
+	int64_t birth = defaultBirthSeconds;
+	if (fields[CHIngestFieldBirthDate].length > 0) {
+		if (!CHIngestParseDate(fields[CHIngestFieldBirthDate], &birth, &hasOffset)) {
+			return CHMeasurementStatusInvalidDate;
+		}
+		if (!hasOffset) {
+			birth -= [self offsetForLocalSeconds:birth];
+		}
+	}
+	else if (!hasDefaultBirthDate) {
+		return CHMeasurementStatusInvalidDate;
+	}
+	if (date < birth) {
+		return CHMeasurementStatusInvalidDate;
+	}
+	batch->_ages[idx] = CHDecimalMake(date - birth, 0);
+
+	return CHMeasurementStatusOK;
+}
+
+
+
+#pragma mark - Resolving
+/**
+ *  Interns the patient, only creating a string when the patient differs from the previous row's.
+ */
+- (CHPatientID)idForPatient:(CHIngestSpan)patient
+{
+	if (0 == patient.length) {
+		return CHPatientIDNone;
+	}
+	if (patient.length == lastPatient.length && 0 == memcmp(patient.bytes, lastPatient.bytes, patient.length)) {
+		return lastPatientID;
+	}
+
+	NSString *string = [[NSString alloc] initWithBytes:patient.bytes length:patient.length encoding:NSUTF8StringEncoding];
+	
+	// keep our own copy, the patient may point into the scratch buffer which the next record overwrites
+	if (patient.length > lastPatientCapacity) {
+		lastPatientCapacity = patient.length;
+		lastPatientBytes = reallocf(lastPatientBytes, lastPatientCapacity);
+	}
+	memcpy(lastPatientBytes, patient.bytes, patient.length);
+	lastPatient = (CHIngestSpan){ lastPatientBytes, patient.length };
+	lastPatientID = CHPatientIDNone;
+	if (string) {
+		NSNumber *existing = _patientIDs[string];
+		if (existing) {
+			lastPatientID = [existing unsignedIntValue];
+		}
+		else if ([_patients count] < UINT32_MAX) {
+			[_patients addObject:string];
+			lastPatientID = (CHPatientID)[_patients count];
+			_patientIDs[string] = @(lastPatientID);
+		}
+	}
+	return lastPatientID;
+}
+
+/**
+ *  @return The patient with the given ID, nil for CHPatientIDNone or unknown IDs
+ */
+- (NSString *)patientForID:(CHPatientID)patientID
+{
+	return (CHPatientIDNone != patientID && patientID <= [_patients count]) ? _patients[patientID - 1] : nil;
+}
+
+- (NSUInteger)numPatients
+{
+	return [_patients count];
+}
+
+/**
+ *  Finds the resolved entry for a data type and unit, resolving it against the unit definitions the first time the pair is seen.
+ */
+- (CHIngestUnitEntry *)unitEntryForDataType:(CHIngestSpan)dataType unit:(CHIngestSpan)unit
+{
+	size_t keyLength = dataType.length + 1 + unit.length;
+
+	// the same pair usually repeats, try the last hit first
+	for (NSUInteger n = 0; n < numUnitEntries; n++) {
+		NSUInteger i = (lastUnitEntry + n) % numUnitEntries;
+		CHIngestUnitEntry *entry = &unitEntries[i];
+		if (keyLength == entry->keyLength
+			&& 0 == memcmp(entry->key, dataType.bytes, dataType.length)
+			&& 0 == memcmp(entry->key + dataType.length + 1, unit.bytes, unit.length)) {
+			lastUnitEntry = i;
+			return entry;
+		}
+	}
+
+	// new pair
+	unitEntries = reallocf(unitEntries, (numUnitEntries + 1) * sizeof(CHIngestUnitEntry));
+	CHIngestUnitEntry *entry = &unitEntries[numUnitEntries];
+	memset(entry, 0, sizeof(CHIngestUnitEntry));
+	entry->key = malloc(keyLength);
+	entry->keyLength = keyLength;
+	memcpy(entry->key, dataType.bytes, dataType.length);
+	entry->key[dataType.length] = '\0';
+	memcpy(entry->key + dataType.length + 1, unit.bytes, unit.length);
+
+	NSString *dataTypeString = [[NSString alloc] initWithBytes:dataType.bytes length:dataType.length encoding:NSUTF8StringEncoding];
+	NSString *unitString = [[NSString alloc] initWithBytes:unit.bytes length:unit.length encoding:NSUTF8StringEncoding];
+	[self resolveEntry:entry dataType:dataTypeString unit:unitString];
+
+	lastUnitEntry = numUnitEntries++;
+	return entry;
+}
+
+/**
+ *  Looks the unit up by path, name or label among the units of the data type and caches how to get to the dimension's base unit.
+ */
+- (void)resolveEntry:(CHIngestUnitEntry *)entry dataType:(NSString *)dataType unit:(NSString *)unitString
+{
+	NSArray *units = dataType ? [CHUnit unitsForDataType:dataType] : nil;
+	if ([units count] < 1) {
+		entry->status = CHMeasurementStatusUnknownDataType;
+		return;
+	}
+	entry->dataType = [[CHStringTable sharedTableNamed:@"dataType"] idForString:dataType];
+
+	CHUnit *unit = nil;
+	if ([unitString length] > 0) {
+		for (CHUnit *candidate in units) {
+			if ([unitString isEqualToString:candidate.path] || [unitString isEqualToString:candidate.name] || [unitString isEqualToString:candidate.label]) {
+				unit = candidate;
+				break;
+			}
+		}
+	}
+	else {
+		unit = [CHUnit defaultUnitForDataType:dataType];
+	}
+
+	CHUnit *baseUnit = nil;
+	[CHUnit unitsOfDimension:unit.dimension baseUnit:&baseUnit];
+	if (!unit || !baseUnit || (!unit.isBaseUnit && !CHDecimalIsDefined(unit.baseMultiplierDecimal))) {
+		DLog(@"Cannot use unit \"%@\" for \"%@\"", unitString, dataType);
+		entry->status = CHMeasurementStatusUnknownUnit;
+		return;
+	}
+
+	entry->status = CHMeasurementStatusOK;
+	entry->baseUnit = [[CHStringTable sharedTableNamed:@"unit"] idForString:baseUnit.path];
+	entry->isBase = unit.isBaseUnit;
+	entry->multiplier = unit.baseMultiplierDecimal;
+	entry->plausibleMin = baseUnit.plausibleMinDecimal;
+	entry->plausibleMax = baseUnit.plausibleMaxDecimal;
+}
+
+
+
+#pragma mark - Time Zone
+/**
+ *  The offset from UTC of a local time given in seconds since 1970, honoring daylight saving time at that date.
+ */
+- (int64_t)offsetForLocalSeconds:(int64_t)local
+{
+	int64_t offset = [self offsetAtSeconds:local];
+	return [self offsetAtSeconds:local - offset];				// near a transition, the offset at the actual UTC time is the right one
+}
+
+/**
+ *  Looks the offset at the given UTC time up in the table of transitions, extending the table if the time is outside of it.
+ */
+- (int64_t)offsetAtSeconds:(int64_t)seconds
+{
+	if (0 == numZoneEntries || seconds < zoneFrom || seconds >= zoneTo) {
+		[self extendZoneTableToInclude:seconds];
+	}
+
+	// the last transition at or before "seconds"
+	NSUInteger low = 0;
+	NSUInteger high = numZoneEntries;
+	while (high - low > 1) {
+		NSUInteger mid = (low + high) / 2;
+		if (zoneStarts[mid] <= seconds) {
+			low = mid;
+		}
+		else {
+			high = mid;
+		}
+	}
+	return zoneOffsets[low];
+}
+
+/**
+ *  Rebuilds the transitions table so it covers its current range, the given time and a year around it. Exports span a few years at most, so this
+ *  only happens a handful of times per enumeration.
+ */
+- (void)extendZoneTableToInclude:(int64_t)seconds
+{
+	static const int64_t margin = 366 * 86400;
+	int64_t from = (numZoneEntries > 0) ? MIN(zoneFrom, seconds - margin) : seconds - margin;
+	int64_t to = (numZoneEntries > 0) ? MAX(zoneTo, seconds + margin) : seconds + margin;
+
+	NSUInteger capacity = 16;
+	NSUInteger count = 1;
+	int64_t *starts = malloc(capacity * sizeof(int64_t));
+	int32_t *offsets = malloc(capacity * sizeof(int32_t));
+	NSDate *date = [NSDate dateWithTimeIntervalSince1970:from];
+	starts[0] = from;
+	offsets[0] = (int32_t)[zone secondsFromGMTForDate:date];
+
+	while ((date = [zone nextDaylightSavingTimeTransitionAfterDate:date]) && [date timeIntervalSince1970] < to) {
+		if (count >= capacity) {
+			capacity *= 2;
+			starts = reallocf(starts, capacity * sizeof(int64_t));
+			offsets = reallocf(offsets, capacity * sizeof(int32_t));
+		}
+		starts[count] = (int64_t)[date timeIntervalSince1970];
+		offsets[count] = (int32_t)[zone secondsFromGMTForDate:date];
+		count++;
+	}
+
+	free(zoneStarts);
+	free(zoneOffsets);
+	zoneStarts = starts;
+	zoneOffsets = offsets;
+	numZoneEntries = count;
+	zoneFrom = from;
+	zoneTo = to;
+}
+
+
+@end
@@ -0,0 +1,38 @@
+//
+//  CHStatsSource.h
+//  Charts
+//
+//  Created by Pascal Pfiffner on 10/19/26.
+//  Copyright (c) 2026 Boston Children's Hospital. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import "CHTypes.h"
+
+
+/**
+ *  A stats source can evaluate a reference distribution, e.g. to draw percentile curves into plot areas.
+ *
+ *  Register sources with CHChartArea's "registerStatsSource:forName:", plot areas look them up by their "statsSource" name.
+ */
+@protocol CHStatsSource <NSObject>
+
+@required
+/**
+ *  The unit path in which the source expects ages, e.g. "age.month".
+ */
+- (NSString *)ageUnitPath;
+
+/**
+ *  The unit path in which the source returns values for the given data type, e.g. "length.centimeter" for "bodylength".
+ */
+- (NSString *)unitPathForDataType:(NSString *)dataType;
+
+/**
+ *  Evaluate the distribution. Return NAN if the source has no data for the given parameters or age.
+ *  @param percentile The percentile, from 0 to 100
+ *  @param age The age, in the unit returned from "ageUnitPath"
+ */
+- (double)valueForDataType:(NSString *)dataType gender:(CHGender)gender percentile:(double)percentile atAge:(double)age;
+
+@end
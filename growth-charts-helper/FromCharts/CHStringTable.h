@@ -0,0 +1,36 @@
+//
+//  CHStringTable.h
+//  Charts
+//
+//  Created by Pascal Pfiffner on 10/19/26.
+//  Copyright (c) 2026 Boston Children's Hospital. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+
+typedef uint16_t CHStringID;						///< 0 is reserved for nil
+
+#define CHStringIDNone 0
+#define CHStringIDMax UINT16_MAX
+
+
+/**
+ *  A table of interned strings, handing out small IDs so that objects repeating the same few strings (area types, data types, unit and font names)
+ *  only need to store the ID.
+ *
+ *  Strings are never removed from a table. All methods are thread safe; "stringForID:" and "count" don't take a lock, since they are called for every
+ *  area that is drawn. A table holds up to CHStringIDMax strings, interning more raises an NSRangeException.
+ */
+@interface CHStringTable : NSObject
+
+@property (nonatomic, readonly) NSUInteger count;			///< The number of strings in the table
+
++ (CHStringTable *)sharedTableNamed:(NSString *)name;
+
+- (CHStringID)idForString:(NSString *)string;
+- (NSString *)stringForID:(CHStringID)stringID;
+
+- (NSUInteger)estimatedMemoryFootprint;
+
+@end
@@ -0,0 +1,156 @@
+//
+//  CHStringTable.m
+//  Charts
+//
+//  Created by Pascal Pfiffner on 10/19/26.
+//  Copyright (c) 2026 Boston Children's Hospital. All rights reserved.
+//
+
+#import "CHStringTable.h"
+#import <objc/runtime.h>
+#import <libkern/OSAtomic.h>
+
+
+#define CHStringTableChunkSize 256					///< Lookup slots per chunk; (CHStringIDMax + 1) / CHStringTableChunkSize chunks cover all IDs
+
+
+@interface CHStringTable ()
+
+@property (nonatomic, strong) NSMutableArray *strings;				///< The interned strings, the string with ID n is at index n - 1. Retains the strings in "lookup".
+@property (nonatomic, strong) NSMutableDictionary *ids;				///< Maps strings to their ID (as NSNumber)
+
+@end
+
+
+@implementation CHStringTable
+{
+	void **lookup[(CHStringIDMax + 1) / CHStringTableChunkSize];	///< Append-only chunks of unretained string pointers, indexed by ID; chunks are never moved or freed while the table lives
+	volatile NSUInteger publishedCount;								///< The number of strings readable from "lookup", only ever grows
+}
+
+
+- (instancetype)init
+{
+	if ((self = [super init])) {
+		self.strings = [NSMutableArray new];
+		self.ids = [NSMutableDictionary new];
+	}
+	return self;
+}
+
+- (void)dealloc
+{
+	for (NSUInteger i = 0; i < (CHStringIDMax + 1) / CHStringTableChunkSize; i++) {
+		free(lookup[i]);
+	}
+}
+
+/**
+ *  Returns the table with the given name, creating it if necessary. Use the same name for strings of the same kind, e.g. "type" or "unit".
+ */
++ (CHStringTable *)sharedTableNamed:(NSString *)name
+{
+	static NSMutableDictionary *tables = nil;
+	static dispatch_once_t onceToken;
+	dispatch_once(&onceToken, ^{
+		tables = [NSMutableDictionary new];
+	});
+	
+	@synchronized(tables) {
+		CHStringTable *table = tables[name];
+		if (!table) {
+			table = [self new];
+			tables[name] = table;
+		}
+		return table;
+	}
+}
+
+
+
+#pragma mark - Interning
+/**
+ *  Returns the ID for the given string, adding the string to the table if it's not yet there.
+ *  @return The string's ID, CHStringIDNone for nil
+ *  @throws NSRangeException if the table already holds CHStringIDMax strings
+ */
+- (CHStringID)idForString:(NSString *)string
+{
+	if (!string) {
+		return CHStringIDNone;
+	}
+	
+	@synchronized(self) {
+		NSNumber *existing = _ids[string];
+		if (existing) {
+			return (CHStringID)[existing unsignedShortValue];
+		}
+		
+		if ([_strings count] >= CHStringIDMax) {
+			[NSException raise:NSRangeException format:@"String table is full, cannot intern \"%@\"", string];
+		}
+		
+		NSString *copy = [string copy];
+		[_strings addObject:copy];
+		CHStringID newID = (CHStringID)[_strings count];
+		_ids[copy] = @(newID);
+		
+		// fill the slot, then publish it; readers check "publishedCount" first so they never see an empty slot
+		NSUInteger chunk = newID / CHStringTableChunkSize;
+		if (!lookup[chunk]) {
+			lookup[chunk] = calloc(CHStringTableChunkSize, sizeof(void *));
+		}
+		lookup[chunk][newID % CHStringTableChunkSize] = (__bridge void *)copy;
+		OSMemoryBarrier();
+		publishedCount = newID;
+		
+		return newID;
+	}
+}
+
+/**
+ *  @return The string with the given ID, nil for CHStringIDNone or unknown IDs
+ */
+- (NSString *)stringForID:(CHStringID)stringID
+{
+	if (CHStringIDNone == stringID) {
+		return nil;
+	}
+	
+	if (stringID > publishedCount) {
+		return nil;
+	}
+	OSMemoryBarrier();
+	return (__bridge NSString *)lookup[stringID / CHStringTableChunkSize][stringID % CHStringTableChunkSize];
+}
+
+- (NSUInteger)count
+{
+	return publishedCount;
+}
+
+
+
+#pragma mark - Memory
+/**
+ *  A rough estimate of how many bytes the table occupies, including the strings.
+ */
+- (NSUInteger)estimatedMemoryFootprint
+{
+	@synchronized(self) {
+		NSUInteger bytes = class_getInstanceSize([self class]);
+		for (NSString *string in _strings) {
+			bytes += class_getInstanceSize([string class]) + [string lengthOfBytesUsingEncoding:NSUTF8StringEncoding];
+		}
+		
+		// the array's and dictionary's storage, two pointers per entry in the dictionary, plus the lookup chunks
+		bytes += [_strings count] * 3 * sizeof(void *);
+		for (NSUInteger i = 0; i < (CHStringIDMax + 1) / CHStringTableChunkSize; i++) {
+			bytes += lookup[i] ? CHStringTableChunkSize * sizeof(void *) : 0;
+		}
+		return bytes;
+	}
+}
+
+
+@end
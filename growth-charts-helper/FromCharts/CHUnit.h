@@ -9,6 +9,7 @@
 #import <Foundation/Foundation.h>
 #import "CHJSONHandling.h"
 #import "CHTypes.h"
+#import "CHDecimal.h"
 
 
 /**
@@ -21,10 +22,13 @@
 @property (nonatomic, copy) NSString *label;						///< The label for the unit, e.g. "cm" for centimeter
 
 @property (nonatomic, assign) short precision;						///< The default precision to round to, 2 by default
-@property (nonatomic, strong) NSDecimalNumber *baseMultiplier;		///< How to convert to base unit
+@property (nonatomic, assign) CHDecimal baseMultiplierDecimal;		///< How to convert to base unit
 @property (nonatomic, assign) BOOL isBaseUnit;
-@property (nonatomic, strong) NSDecimalNumber *plausibleMin;
-@property (nonatomic, strong) NSDecimalNumber *plausibleMax;
+@property (nonatomic, assign) CHDecimal plausibleMinDecimal;
+@property (nonatomic, assign) CHDecimal plausibleMaxDecimal;
+@property (nonatomic, copy) NSDecimalNumber *baseMultiplier;		///< "baseMultiplierDecimal" as NSDecimalNumber
+@property (nonatomic, copy) NSDecimalNumber *plausibleMin;			///< "plausibleMinDecimal" as NSDecimalNumber
+@property (nonatomic, copy) NSDecimalNumber *plausibleMax;			///< "plausibleMaxDecimal" as NSDecimalNumber
 
 
 + (NSArray *)unitsOfDimension:(NSString *)dimension baseUnit:(CHUnit * __autoreleasing *)defaultUnit;
@@ -37,18 +41,25 @@
 - (NSString *)stringValueForNumber:(NSDecimalNumber *)number;
 - (NSString *)stringValueForNumber:(NSDecimalNumber *)number withSize:(CHValueStringSize)size;
 - (NSString *)stringValueForNumberOnly:(NSDecimalNumber *)number;
+- (NSString *)stringValueForDecimal:(CHDecimal)decimal withSize:(CHValueStringSize)size;
 
 - (NSDecimalNumber *)numberInBaseUnit:(NSDecimalNumber *)number;
 - (NSDecimalNumber *)convertNumber:(NSDecimalNumber *)number toUnit:(CHUnit *)unit;
 - (NSDecimalNumber *)roundedNumber:(NSDecimalNumber *)number;
+- (CHDecimal)decimalInBaseUnit:(CHDecimal)decimal;
+- (CHDecimal)decimalFromBaseUnit:(CHDecimal)decimal;
+- (CHDecimal)convertDecimal:(CHDecimal)decimal toUnit:(CHUnit *)unit;
+- (CHDecimal)roundedDecimal:(CHDecimal)decimal;
 
 - (BOOL)isSameDimension:(CHUnit *)otherUnit;
 
 - (NSInteger)checkPlausibilityOfNumber:(NSDecimalNumber *)number;
+- (NSInteger)checkPlausibilityOfDecimal:(CHDecimal)decimal;
 - (void)setMinPlausibleFromBaseUnit:(NSString *)numString;
 - (void)setMaxPlausibleFromBaseUnit:(NSString *)numString;
 
 + (NSDictionary *)dictionaryForDimension:(NSString *)dimension;
++ (BOOL)isKnownUnitPath:(NSString *)aPath;
 + (Class)classForDimension:(NSString *)dimension;
 
 + (CHUnit *)defaultUnitForDataType:(NSString *)measurementType;
@@ -70,23 +70,13 @@
 
 /**
  *  Returns the string value for a number and the unit label in the receiver's unit, with the given size.
- *
- *  Subclasses should override this method.
  */
 - (NSString *)stringValueForNumber:(NSDecimalNumber *)number withSize:(CHValueStringSize)size
 {
 	if (!number) {
 		return nil;
 	}
-	
-	if (CHValueStringSizeCompact == size) {
-		return [NSString stringWithFormat:@"%@%@", [self roundedNumber:number], (_label ? _label : @"")];
-	}
-	if (CHValueStringSizeLong == size) {
-		return [NSString stringWithFormat:@"%@ %@", [self roundedNumber:number], (_name ? _name : (_label ? _label : @""))];
-	}
-	
-	return [NSString stringWithFormat:@"%@ %@", [self roundedNumber:number], (_label ? _label : @"")];
+	return [self stringValueForDecimal:CHDecimalFromNumber(number) withSize:size];
 }
 
 /**
@@ -94,7 +84,29 @@
  */
 - (NSString *)stringValueForNumberOnly:(NSDecimalNumber *)number
 {
-	return [[self roundedNumber:number] description];
+	return CHDecimalString([self roundedDecimal:CHDecimalFromNumber(number)]);
+}
+
+/**
+ *  Returns the string value for a decimal and the unit label in the receiver's unit, with the given size.
+ *
+ *  Subclasses should override this method.
+ */
+- (NSString *)stringValueForDecimal:(CHDecimal)decimal withSize:(CHValueStringSize)size
+{
+	if (!CHDecimalIsDefined(decimal)) {
+		return nil;
+	}
+	
+	NSString *rounded = CHDecimalString([self roundedDecimal:decimal]);
+	if (CHValueStringSizeCompact == size) {
+		return [NSString stringWithFormat:@"%@%@", rounded, (_label ? _label : @"")];
+	}
+	if (CHValueStringSizeLong == size) {
+		return [NSString stringWithFormat:@"%@ %@", rounded, (_name ? _name : (_label ? _label : @""))];
+	}
+	
+	return [NSString stringWithFormat:@"%@ %@", rounded, (_label ? _label : @"")];
 }
 
 
@@ -106,69 +118,92 @@
  */
 - (NSDecimalNumber *)numberInBaseUnit:(NSDecimalNumber *)number
 {
-	if (_isBaseUnit) {
+	return CHDecimalNumber([self decimalInBaseUnit:CHDecimalFromNumber(number)]);
+}
+
+/**
+ *  Assumes that number is in the receivers unit and converts it to the given unit.
+ */
+- (NSDecimalNumber *)convertNumber:(NSDecimalNumber *)number toUnit:(CHUnit *)unit
+{
+	if (!unit || [self isEqual:unit]) {
 		return number;
 	}
-	if (_baseMultiplier) {
-		return [number decimalNumberByMultiplyingBy:_baseMultiplier];
+	return CHDecimalNumber([self convertDecimal:CHDecimalFromNumber(number) toUnit:unit]);
+}
+
+/**
+ *  Rounds the number according to the unit's information.
+ */
+- (NSDecimalNumber *)roundedNumber:(NSDecimalNumber *)number
+{
+	return CHDecimalNumber([self roundedDecimal:CHDecimalFromNumber(number)]);
+}
+
+/**
+ *  Convert the decimal from the receiver's unit to the unit dimension's base unit.
+ *  @param decimal A decimal in the receiver's unit
+ */
+- (CHDecimal)decimalInBaseUnit:(CHDecimal)decimal
+{
+	if (_isBaseUnit) {
+		return decimal;
+	}
+	if (CHDecimalIsDefined(_baseMultiplierDecimal)) {
+		return CHDecimalMultiply(decimal, _baseMultiplierDecimal);
 	}
 	
 	DLog(@"I need the base multiplier in order to convert a number to base unit, but I don't have one. %@", self);
-	return number;
+	return decimal;
 }
 
 /**
- *  Convert the number from the base unit to the receiver's unit.
- *  @param number A number in the base unit
+ *  Convert the decimal from the base unit to the receiver's unit.
+ *  @param decimal A decimal in the base unit
  */
-- (NSDecimalNumber *)numberFromBaseUnit:(NSDecimalNumber *)number
+- (CHDecimal)decimalFromBaseUnit:(CHDecimal)decimal
 {
 	if (_isBaseUnit) {
-		return number;
+		return decimal;
 	}
-	if (_baseMultiplier) {
-		return [number decimalNumberByDividingBy:_baseMultiplier];
+	if (CHDecimalIsDefined(_baseMultiplierDecimal)) {
+		if (CHDecimalIsNumber(_baseMultiplierDecimal) && 0 == _baseMultiplierDecimal.mantissa) {
+			[NSException raise:NSDecimalNumberDivideByZeroException format:@"The base multiplier of %@ is zero", self];
+		}
+		return CHDecimalDivide(decimal, _baseMultiplierDecimal);
 	}
 	
 	DLog(@"I need the base multiplier in order to convert a number from base unit, but I don't have one. %@", self);
-	return number;
+	return decimal;
 }
 
 /**
- *  Assumes that number is in the receivers unit and converts it to the given unit.
+ *  Assumes that the decimal is in the receivers unit and converts it to the given unit.
+ *  @return The converted decimal, undefined if the unit is of another dimension
  */
-- (NSDecimalNumber *)convertNumber:(NSDecimalNumber *)number toUnit:(CHUnit *)unit
+- (CHDecimal)convertDecimal:(CHDecimal)decimal toUnit:(CHUnit *)unit
 {
 	// no unit or same unit anyway?
 	if (!unit || [self isEqual:unit]) {
-		return number;
+		return decimal;
 	}
 	
 	// must be same dimension
 	if (![self isSameDimension:unit]) {
 		DLog(@"I can not convert to a unit from another dimension (%@ -> %@)", self.dimension, unit.dimension);
-		return nil;
+		return CHDecimalMakeUndefined();
 	}
 	
 	// convert
-	return [unit numberFromBaseUnit:[self numberInBaseUnit:number]];
+	return [unit decimalFromBaseUnit:[self decimalInBaseUnit:decimal]];
 }
 
 /**
- *  Rounds the number according to the unit's information.
+ *  Rounds the decimal according to the unit's precision.
  */
-- (NSDecimalNumber *)roundedNumber:(NSDecimalNumber *)number
+- (CHDecimal)roundedDecimal:(CHDecimal)decimal
 {
-	if (number) {
-		NSDecimalNumberHandler *roundingBehavior = [[NSDecimalNumberHandler alloc] initWithRoundingMode:NSRoundPlain
-																								  scale:_precision
-																					   raiseOnExactness:NO
-																						raiseOnOverflow:NO
-																					   raiseOnUnderflow:NO
-																					raiseOnDivideByZero:NO];
-		return [number decimalNumberByRoundingAccordingToBehavior:roundingBehavior];
-	}
-	return nil;
+	return CHDecimalRound(decimal, _precision, NSRoundPlain);
 }
 
 
@@ -179,14 +214,22 @@
  */
 - (NSInteger)checkPlausibilityOfNumber:(NSDecimalNumber *)number
 {
-	if (!number || [number isEqual:[NSDecimalNumber notANumber]]) {
+	return [self checkPlausibilityOfDecimal:CHDecimalFromNumber(number)];
+}
+
+/**
+ *  Checks whether a decimal in the receiver's unit physiologically makes sense; 0 is plausible, -1 too low and 1 too high.
+ */
+- (NSInteger)checkPlausibilityOfDecimal:(CHDecimal)decimal
+{
+	if (!CHDecimalIsDefined(decimal) || CHDecimalIsNotANumber(decimal)) {
 		return 0;
 	}
 	
-	if (_plausibleMin && NSOrderedAscending == [number compare:_plausibleMin]) {
+	if (CHDecimalIsDefined(_plausibleMinDecimal) && NSOrderedAscending == CHDecimalCompare(decimal, _plausibleMinDecimal)) {
 		return -1;
 	}
-	if (_plausibleMax && NSOrderedDescending == [number compare:_plausibleMax]) {
+	if (CHDecimalIsDefined(_plausibleMaxDecimal) && NSOrderedDescending == CHDecimalCompare(decimal, _plausibleMaxDecimal)) {
 		return 1;
 	}
 	return 0;
@@ -197,13 +240,12 @@
 	if ([numString length] < 1) {
 		return;
 	}
-	if (!_isBaseUnit && !_baseMultiplier) {
+	if (!_isBaseUnit && !CHDecimalIsDefined(_baseMultiplierDecimal)) {
 		DLog(@"I need to know the base unit first");
 		return;
 	}
 	
-	NSDecimalNumber *number = [NSDecimalNumber decimalNumberWithString:numString];
-	self.plausibleMin = [self numberFromBaseUnit:number];
+	self.plausibleMinDecimal = [self decimalFromBaseUnit:CHDecimalFromString(numString)];
 }
 
 - (void)setMaxPlausibleFromBaseUnit:(NSString *)numString
@@ -211,13 +253,12 @@
 	if ([numString length] < 1) {
 		return;
 	}
-	if (!_isBaseUnit && !_baseMultiplier) {
+	if (!_isBaseUnit && !CHDecimalIsDefined(_baseMultiplierDecimal)) {
 		DLog(@"I need to know the base unit first");
 		return;
 	}
 	
-	NSDecimalNumber *number = [NSDecimalNumber decimalNumberWithString:numString];
-	self.plausibleMax = [self numberFromBaseUnit:number];
+	self.plausibleMaxDecimal = [self decimalFromBaseUnit:CHDecimalFromString(numString)];
 }
 
 
@@ -293,7 +334,7 @@
 	unit.dimension = dimension;
 	unit.name = ([name length] > 0) ? name : dict[@"name"];
 	unit.label = dict[@"label"];
-	unit.baseMultiplier = dict[@"baseMultiplier"] ? [NSDecimalNumber decimalNumberWithString:dict[@"baseMultiplier"]] : nil;
+	unit.baseMultiplierDecimal = dict[@"baseMultiplier"] ? CHDecimalFromString(dict[@"baseMultiplier"]) : CHDecimalMakeUndefined();
 	NSNumber *precision = dict[@"precision"];
 	if (precision) {
 		unit.precision = [precision shortValue];
@@ -397,13 +438,36 @@
 + (NSDictionary *)allUnitsDict
 {
 	static NSDictionary *allUnitsDict = nil;
-	if (!allUnitsDict) {
+	static dispatch_once_t onceToken;
+	dispatch_once(&onceToken, ^{							// the linter looks up units from several threads
 		NSURL *url = [[NSBundle bundleForClass:self] URLForResource:@"units" withExtension:@"plist"];
 		allUnitsDict = [NSDictionary dictionaryWithContentsOfURL:url];
-	}
+	});
 	return allUnitsDict;
 }
 
+/**
+ *  @return YES if the path, e.g. "length.centimeter", names a unit we know about
+ */
++ (BOOL)isKnownUnitPath:(NSString *)aPath
+{
+	NSArray *parts = [aPath componentsSeparatedByString:@"."];
+	if (2 != [parts count]) {
+		return NO;
+	}
+	
+	NSDictionary *dimDict = [self dictionaryForDimension:parts[0]];
+	if ([parts[1] isEqualToString:dimDict[@"base"]]) {
+		return YES;
+	}
+	for (NSDictionary *unitDict in dimDict[@"units"]) {
+		if ([parts[1] isEqualToString:unitDict[@"name"]]) {
+			return YES;
+		}
+	}
+	return NO;
+}
+
 + (Class)classForDimension:(NSString *)dimension
 {
 	if ([@"age" isEqualToString:dimension]) {
@@ -437,6 +501,54 @@
 
 
 
+#pragma mark - NSDecimalNumber Properties
+- (NSDecimalNumber *)baseMultiplier
+{
+	return CHDecimalNumber(_baseMultiplierDecimal);
+}
+
+- (void)setBaseMultiplier:(NSDecimalNumber *)number
+{
+	self.baseMultiplierDecimal = CHDecimalFromNumber(number);
+}
+
++ (NSSet *)keyPathsForValuesAffectingBaseMultiplier
+{
+	return [NSSet setWithObject:@"baseMultiplierDecimal"];
+}
+
+- (NSDecimalNumber *)plausibleMin
+{
+	return CHDecimalNumber(_plausibleMinDecimal);
+}
+
+- (void)setPlausibleMin:(NSDecimalNumber *)number
+{
+	self.plausibleMinDecimal = CHDecimalFromNumber(number);
+}
+
++ (NSSet *)keyPathsForValuesAffectingPlausibleMin
+{
+	return [NSSet setWithObject:@"plausibleMinDecimal"];
+}
+
+- (NSDecimalNumber *)plausibleMax
+{
+	return CHDecimalNumber(_plausibleMaxDecimal);
+}
+
+- (void)setPlausibleMax:(NSDecimalNumber *)number
+{
+	self.plausibleMaxDecimal = CHDecimalFromNumber(number);
+}
+
++ (NSSet *)keyPathsForValuesAffectingPlausibleMax
+{
+	return [NSSet setWithObject:@"plausibleMaxDecimal"];
+}
+
+
+
 #pragma mark - Comparison
 - (NSString *)path
 {
@@ -471,7 +583,7 @@
 	newUnit.name = _name;
 	newUnit.label = _label;
 	newUnit.precision = _precision;
-	newUnit.baseMultiplier = _baseMultiplier;
+	newUnit.baseMultiplierDecimal = _baseMultiplierDecimal;
 	newUnit.isBaseUnit = _isBaseUnit;
 	
 	return newUnit;
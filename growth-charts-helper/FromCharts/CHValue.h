@@ -9,6 +9,7 @@
 #import <Foundation/Foundation.h>
 #import "CHTypes.h"
 #import "CHJSONHandling.h"
+#import "CHDecimal.h"
 
 @class CHUnit;
 
@@ -18,10 +19,12 @@
  */
 @interface CHValue : NSObject <NSCopying, CHJSONHandling>
 
-@property (nonatomic, strong) NSDecimalNumber *number;				///< The numeric value
+@property (nonatomic, assign) CHDecimal decimal;					///< The numeric value
+@property (nonatomic, copy) NSDecimalNumber *number;				///< The numeric value as NSDecimalNumber, backed by "decimal"
 @property (nonatomic, strong) CHUnit *unit;							///< The unit
 
 + (id)newWithNumber:(NSDecimalNumber *)number inUnit:(CHUnit *)unit;
++ (id)newWithDecimal:(CHDecimal)decimal inUnit:(CHUnit *)unit;
 
 - (BOOL)convertToUnit:(CHUnit *)aUnit;
 - (CHValue *)valueInUnit:(CHUnit *)aUnit;
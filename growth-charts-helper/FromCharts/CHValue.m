@@ -14,9 +14,14 @@
 
 
 + (id)newWithNumber:(NSDecimalNumber *)number inUnit:(CHUnit *)unit
+{
+	return [self newWithDecimal:CHDecimalFromNumber(number) inUnit:unit];
+}
+
++ (id)newWithDecimal:(CHDecimal)decimal inUnit:(CHUnit *)unit
 {
 	CHValue *value = [self new];
-	value.number = number;
+	value.decimal = decimal;
 	value.unit = unit;
 	
 	return value;
@@ -25,16 +30,31 @@
 
 
 #pragma mark - Properties
+- (NSDecimalNumber *)number
+{
+	return CHDecimalNumber(_decimal);
+}
+
+- (void)setNumber:(NSDecimalNumber *)number
+{
+	self.decimal = CHDecimalFromNumber(number);
+}
+
++ (NSSet *)keyPathsForValuesAffectingNumber
+{
+	return [NSSet setWithObject:@"decimal"];
+}
+
 /**
  *  Checks whether the measurement seems physiologically plausible; 0 is plausible, -1 too low and 1 too high.
  */
 - (NSInteger)checkPlausibility
 {
-	if (!_number || !_unit) {
+	if (!CHDecimalIsDefined(_decimal) || !_unit) {
 		return 0;
 	}
 	
-	return [_unit checkPlausibilityOfNumber:_number];
+	return [_unit checkPlausibilityOfDecimal:_decimal];
 }
 
 /**
@@ -42,7 +62,7 @@
  */
 - (BOOL)isNull
 {
-	return (nil == _number);
+	return !CHDecimalIsDefined(_decimal);
 }
 
 
@@ -50,12 +70,12 @@
 #pragma mark - Conversion
 - (BOOL)convertToUnit:(CHUnit *)aUnit
 {
-	NSDecimalNumber *newNumber = (_unit && aUnit) ? [_unit convertNumber:_number toUnit:aUnit] : _number;
-	if (_number && !newNumber) {
+	CHDecimal newDecimal = (_unit && aUnit) ? [_unit convertDecimal:_decimal toUnit:aUnit] : _decimal;
+	if (CHDecimalIsDefined(_decimal) && !CHDecimalIsDefined(newDecimal)) {
 		return NO;
 	}
 	
-	self.number = newNumber;
+	self.decimal = newDecimal;
 	self.unit = aUnit;
 	
 	return YES;
@@ -66,12 +86,12 @@
  */
 - (CHValue *)valueInUnit:(CHUnit *)aUnit
 {
-	NSDecimalNumber *newNumber = (_unit && aUnit) ? [_unit convertNumber:_number toUnit:aUnit] : _number;
-	if (_number && !newNumber) {
+	CHDecimal newDecimal = (_unit && aUnit) ? [_unit convertDecimal:_decimal toUnit:aUnit] : _decimal;
+	if (CHDecimalIsDefined(_decimal) && !CHDecimalIsDefined(newDecimal)) {
 		return nil;
 	}
 	
-	return [[self class] newWithNumber:newNumber inUnit:aUnit];
+	return [[self class] newWithDecimal:newDecimal inUnit:aUnit];
 }
 
 - (CHValue *)valueInUnitWithName:(NSString *)unitName
@@ -85,13 +105,13 @@
  */
 - (NSDecimalNumber *)numberInUnit:(CHUnit *)aUnit
 {
-	return [_unit convertNumber:_number toUnit:aUnit];
+	return _unit ? CHDecimalNumber([_unit convertDecimal:_decimal toUnit:aUnit]) : nil;
 }
 
 - (NSDecimalNumber *)numberInUnitWithName:(NSString *)unitName
 {
 	CHUnit *otherUnit = [CHUnit newWithPath:[NSString stringWithFormat:@"%@.%@", _unit.dimension, unitName]];
-	return [_unit convertNumber:_number toUnit:otherUnit];
+	return _unit ? CHDecimalNumber([_unit convertDecimal:_decimal toUnit:otherUnit]) : nil;
 }
 
 
@@ -113,9 +133,9 @@
 - (NSString *)stringValueWithSize:(CHValueStringSize)size
 {
 	if (_unit) {
-		return [_unit stringValueForNumber:_number withSize:size];
+		return [_unit stringValueForDecimal:_decimal withSize:size];
 	}
-	return _number ? [_number stringValue] : @"";
+	return CHDecimalIsDefined(_decimal) ? CHDecimalString(_decimal) : @"";
 }
 
 /**
@@ -124,9 +144,9 @@
 - (NSString *)numericStringValue
 {
 	if (_unit) {
-		return [_unit stringValueForNumberOnly:_number];
+		return CHDecimalString([_unit roundedDecimal:_decimal]);
 	}
-	return _number ? [_number stringValue] : @"";
+	return CHDecimalIsDefined(_decimal) ? CHDecimalString(_decimal) : @"";
 }
 
 
@@ -134,7 +154,7 @@
 #pragma mark - NSCopying
 - (id)copyWithZone:(NSZone *)zone
 {
-	return [[self class] newWithNumber:_number inUnit:_unit];
+	return [[self class] newWithDecimal:_decimal inUnit:_unit];
 }
 
 
@@ -154,10 +174,10 @@
 	if ([obj isKindOfClass:[NSDictionary class]]) {
 		NSString *number = obj[@"number"];
 		if ([number isKindOfClass:[NSString class]]) {
-			self.number = [NSDecimalNumber decimalNumberWithString:number];
+			self.decimal = CHDecimalFromString(number);
 		}
 		else if ([number respondsToSelector:@selector(description)]) {
-			self.number = [NSDecimalNumber decimalNumberWithString:[number description]];
+			self.decimal = CHDecimalFromString([number description]);
 		}
 		
 		NSString *unit = obj[@"unit"];
@@ -172,8 +192,8 @@
 - (id)jsonObject
 {
 	NSMutableDictionary *dict = [NSMutableDictionary dictionary];
-	if (_number) {
-		dict[@"number"] = [_number description];		// yes, we want the number as string
+	if (CHDecimalIsDefined(_decimal)) {
+		dict[@"number"] = CHDecimalString(_decimal);	// yes, we want the number as string
 	}
 	if (_unit) {
 		dict[@"unit"] = [_unit jsonObject];
@@ -187,7 +207,7 @@
 #pragma mark - Utilities
 - (NSString *)description
 {
-	return [NSString stringWithFormat:@"%@ <%p> %@ %@", NSStringFromClass([self class]), self, _number, _unit.name];
+	return [NSString stringWithFormat:@"%@ <%p> %@ %@", NSStringFromClass([self class]), self, CHDecimalString(_decimal), _unit.name];
 }
 
 
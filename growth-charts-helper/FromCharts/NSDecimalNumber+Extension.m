@@ -7,6 +7,7 @@
 //
 
 #import "NSDecimalNumber+Extension.h"
+#import "CHDecimal.h"
 
 @implementation NSDecimalNumber (Extension)
 
@@ -16,18 +17,7 @@
  */
 - (NSDecimalNumber *)moduloFor:(NSDecimalNumber *)divisor
 {
-	NSRoundingMode roundingMode = (([self intValue] < 0) ^ ([self intValue] < 0)) ? NSRoundUp : NSRoundDown;
-	NSDecimalNumberHandler *rounding = [NSDecimalNumberHandler decimalNumberHandlerWithRoundingMode:roundingMode
-																							  scale:0
-																				   raiseOnExactness:NO
-																					raiseOnOverflow:NO
-																				   raiseOnUnderflow:NO
-																				raiseOnDivideByZero:NO];
-	
-	// divide and get the remainder
-	NSDecimalNumber *quotient = [self decimalNumberByDividingBy:divisor withBehavior:rounding];
-	NSDecimalNumber *subtract = [quotient decimalNumberByMultiplyingBy:divisor];
-	return [self decimalNumberBySubtracting:subtract];
+	return CHDecimalNumber(CHDecimalModulo(CHDecimalFromNumber(self), CHDecimalFromNumber(divisor)));
 }
 
 
@@ -36,8 +26,8 @@
  */
 - (NSDecimalNumber *)moduloForDouble:(double)divisor
 {
-	NSDecimalNumber *div = [NSDecimalNumber decimalNumberWithString:[NSString stringWithFormat:@"%f", divisor]];
-	return [self moduloFor:div];
+	CHDecimal div = CHDecimalFromDouble(divisor, 6);
+	return CHDecimalNumber(CHDecimalModulo(CHDecimalFromNumber(self), div));
 }
 
 
@@ -59,9 +49,9 @@
  */
 - (NSDecimalNumber *)absoluteNumber
 {
-	if (NSOrderedDescending == [[NSDecimalNumber zero] compare:self]) {
-		NSDecimalNumber *negOne = [NSDecimalNumber decimalNumberWithMantissa:1 exponent:0 isNegative:YES];
-		return [self decimalNumberByMultiplyingBy:negOne];
+	CHDecimal dec = CHDecimalFromNumber(self);
+	if (NSOrderedAscending == CHDecimalCompare(dec, CHDecimalMake(0, 0))) {
+		return CHDecimalNumber(CHDecimalAbsolute(dec));
 	}
 	return self;
 }
@@ -74,7 +64,7 @@
  */
 - (NSDecimalNumber *)greaterNumber:(NSDecimalNumber *)number
 {
-	if (NSOrderedAscending == [self compare:number]) {
+	if (NSOrderedAscending == CHDecimalCompare(CHDecimalFromNumber(self), CHDecimalFromNumber(number))) {
 		return number;
 	}
 	return self;
@@ -85,7 +75,7 @@
  */
 - (NSDecimalNumber *)smallerNumber:(NSDecimalNumber *)number
 {
-	if (NSOrderedDescending == [self compare:number]) {
+	if (NSOrderedDescending == CHDecimalCompare(CHDecimalFromNumber(self), CHDecimalFromNumber(number))) {
 		return number;
 	}
 	return self;
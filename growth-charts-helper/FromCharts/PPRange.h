@@ -14,6 +14,7 @@
 //
 
 #import <Foundation/Foundation.h>
+#import "CHDecimal.h"
 
 
 typedef NS_ENUM(unsigned int, PPRangeDisplayStyle) {
@@ -50,18 +51,23 @@ typedef NS_ENUM(unsigned int, PPRangeResult) {
 
 @property (nonatomic, copy) NSString *stringValue;		///< The string representation; changing the string changes the bounds!
 
-@property (nonatomic, copy) NSDecimalNumber *from;		///< The lower limit
+@property (nonatomic, assign) CHDecimal fromDecimal;	///< The lower limit; undefined if there is none, minus infinity for "< x"
 @property (nonatomic, assign) BOOL includingFrom;		///< YES by default, changed automatically when parsing from string
-@property (nonatomic, copy) NSDecimalNumber *to;		///< The upper limit
+@property (nonatomic, assign) CHDecimal toDecimal;		///< The upper limit; undefined if there is none, plus infinity for "> x"
 @property (nonatomic, assign) BOOL includingTo;			///< YES by default, changed automatically when parsing from string
 
+@property (nonatomic, copy) NSDecimalNumber *from;		///< The lower limit as NSDecimalNumber, backed by "fromDecimal"
+@property (nonatomic, copy) NSDecimalNumber *to;		///< The upper limit as NSDecimalNumber, backed by "toDecimal"
+
 + (PPRange *)rangeWithString:(NSString *)string;
 + (PPRange *)rangeFrom:(NSDecimalNumber *)min to:(NSDecimalNumber *)max;
++ (PPRange *)rangeFromDecimal:(CHDecimal)min toDecimal:(CHDecimal)max;
 + (PPRange *)rangeFromString:(NSString *)min toString:(NSString *)max;
 - (instancetype)initWithString:(NSString *)string;
 
 - (BOOL)contains:(NSNumber *)test;
 - (PPRangeResult)test:(NSNumber *)test;
+- (PPRangeResult)testDecimal:(CHDecimal)test;
 
 - (PPRange *)copyWithCustomFrom:(NSDecimalNumber *)min to:(NSDecimalNumber *)max;
 - (BOOL)isDefined;
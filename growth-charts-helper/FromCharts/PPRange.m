@@ -33,22 +33,27 @@
 
 + (PPRange *)rangeFrom:(NSDecimalNumber *)min to:(NSDecimalNumber *)max
 {
-	if (min || max) {
+	return [self rangeFromDecimal:CHDecimalFromNumber(min) toDecimal:CHDecimalFromNumber(max)];
+}
+
++ (PPRange *)rangeFromDecimal:(CHDecimal)min toDecimal:(CHDecimal)max
+{
+	if (CHDecimalIsDefined(min) || CHDecimalIsDefined(max)) {
 		PPRange *r = [self new];
-		r.from = min;
-		r.to = max;
+		r.fromDecimal = min;
+		r.toDecimal = max;
 		return r;
 	}
 	return nil;
 }
 
 /**
- *  Creates NSDecimalNumber instances from min and max string and creates a range with these limits
+ *  Parses min and max strings and creates a range with these limits
  */
 + (PPRange *)rangeFromString:(NSString *)min toString:(NSString *)max
 {
-	return [PPRange rangeFrom:(min ? [NSDecimalNumber decimalNumberWithString:min] : nil)
-						   to:(max ? [NSDecimalNumber decimalNumberWithString:max] : nil)];
+	return [PPRange rangeFromDecimal:(min ? CHDecimalFromString(min) : CHDecimalMakeUndefined())
+						   toDecimal:(max ? CHDecimalFromString(max) : CHDecimalMakeUndefined())];
 }
 
 /**
@@ -64,12 +69,45 @@
 
 
 
+#pragma mark - Properties
+- (NSDecimalNumber *)from
+{
+	return CHDecimalNumber(_fromDecimal);
+}
+
+- (void)setFrom:(NSDecimalNumber *)from
+{
+	self.fromDecimal = CHDecimalFromNumber(from);
+}
+
++ (NSSet *)keyPathsForValuesAffectingFrom
+{
+	return [NSSet setWithObject:@"fromDecimal"];
+}
+
+- (NSDecimalNumber *)to
+{
+	return CHDecimalNumber(_toDecimal);
+}
+
+- (void)setTo:(NSDecimalNumber *)to
+{
+	self.toDecimal = CHDecimalFromNumber(to);
+}
+
++ (NSSet *)keyPathsForValuesAffectingTo
+{
+	return [NSSet setWithObject:@"toDecimal"];
+}
+
+
+
 #pragma mark - NSCopying
 - (id)copyWithZone:(NSZone *)zone
 {
 	PPRange *newRange = [[[self class] allocWithZone:zone] init];
-	newRange->_from = [_from copyWithZone:zone];
-	newRange->_to = [_to copyWithZone:zone];
+	newRange->_fromDecimal = _fromDecimal;
+	newRange->_toDecimal = _toDecimal;
 	newRange->_includingFrom = _includingFrom;
 	newRange->_includingTo = _includingTo;
 	
@@ -79,8 +117,8 @@
 - (PPRange *)copyWithCustomFrom:(NSDecimalNumber *)min to:(NSDecimalNumber *)max
 {
 	PPRange *newRange = [[self class] new];
-	newRange->_from = min ? [min copy] : [_from copy];
-	newRange->_to = max ? [max copy] : [_to copy];
+	newRange->_fromDecimal = min ? CHDecimalFromNumber(min) : _fromDecimal;
+	newRange->_toDecimal = max ? CHDecimalFromNumber(max) : _toDecimal;
 	newRange->_includingFrom = _includingFrom;
 	newRange->_includingTo = _includingTo;
 	
@@ -92,8 +130,8 @@
 #pragma mark - NSCoding
 - (void)encodeWithCoder:(NSCoder *)encoder
 {
-	[encoder encodeObject:_from forKey:@"from"];
-	[encoder encodeObject:_to forKey:@"to"];
+	[encoder encodeObject:self.from forKey:@"from"];		// keep archives readable by older versions
+	[encoder encodeObject:self.to forKey:@"to"];
 	[encoder encodeBool:_includingFrom forKey:@"includingFrom"];
 	[encoder encodeBool:_includingTo forKey:@"includingTo"];
 }
@@ -125,21 +163,29 @@
  */
 - (PPRangeResult)test:(NSNumber *)test
 {
-	if (!test) {
+	return [self testDecimal:CHDecimalFromNumber(test)];
+}
+
+/**
+ *  Tests whether a given decimal falls into our range
+ */
+- (PPRangeResult)testDecimal:(CHDecimal)test
+{
+	if (!CHDecimalIsDefined(test)) {
 		return PPRangeResultUndefined;
 	}
 	
 	// check lower bounds
-	if (_from) {
-		NSComparisonResult lowerTest = [_from compare:test];
+	if (CHDecimalIsDefined(_fromDecimal)) {
+		NSComparisonResult lowerTest = CHDecimalCompare(_fromDecimal, test);
 		if ((NSOrderedDescending == lowerTest) || (NSOrderedSame == lowerTest && !_includingFrom)) {
 			return PPRangeResultTooLow;
 		}
 	}
 	
 	// check upper bounds
-	if (_to) {
-		NSComparisonResult upperTest = [_to compare:test];
+	if (CHDecimalIsDefined(_toDecimal)) {
+		NSComparisonResult upperTest = CHDecimalCompare(_toDecimal, test);
 		if ((NSOrderedAscending == upperTest) || (NSOrderedSame == upperTest && !_includingTo)) {
 			return PPRangeResultTooHigh;
 		}
@@ -153,14 +199,19 @@
 #pragma mark - Conversions
 - (void)multiplyBy:(NSDecimalNumber *)factor
 {
-	self.from = [_from decimalNumberByMultiplyingBy:factor];
-	self.to = [_to decimalNumberByMultiplyingBy:factor];
+	CHDecimal dec = CHDecimalFromNumber(factor);
+	self.fromDecimal = CHDecimalMultiply(_fromDecimal, dec);
+	self.toDecimal = CHDecimalMultiply(_toDecimal, dec);
 }
 
 - (void)divideBy:(NSDecimalNumber *)divisor
 {
-	self.from = [_from decimalNumberByDividingBy:divisor];
-	self.to = [_to decimalNumberByDividingBy:divisor];
+	CHDecimal dec = CHDecimalFromNumber(divisor);
+	if (CHDecimalIsNumber(dec) && 0 == dec.mantissa) {
+		[NSException raise:NSDecimalNumberDivideByZeroException format:@"Cannot divide a range by zero"];
+	}
+	self.fromDecimal = CHDecimalDivide(_fromDecimal, dec);
+	self.toDecimal = CHDecimalDivide(_toDecimal, dec);
 }
 
 /**
@@ -179,41 +230,20 @@
  */
 - (void)roundToPrecision:(short)precision
 {
-	NSDecimalNumberHandler *roundingBehavior = [[NSDecimalNumberHandler alloc] initWithRoundingMode:NSRoundPlain
-																							  scale:precision
-																				   raiseOnExactness:NO
-																					raiseOnOverflow:NO
-																				   raiseOnUnderflow:NO
-																				raiseOnDivideByZero:NO];
-	self.from = [_from decimalNumberByRoundingAccordingToBehavior:roundingBehavior];
-	self.to = [_to decimalNumberByRoundingAccordingToBehavior:roundingBehavior];
-	
+	self.fromDecimal = CHDecimalRound(_fromDecimal, precision, NSRoundPlain);
+	self.toDecimal = CHDecimalRound(_toDecimal, precision, NSRoundPlain);
 }
 
 - (void)ceil
 {
-	NSDecimalNumberHandler *roundingBehavior = [[NSDecimalNumberHandler alloc] initWithRoundingMode:NSRoundUp
-																							  scale:0
-																				   raiseOnExactness:NO
-																					raiseOnOverflow:NO
-																				   raiseOnUnderflow:NO
-																				raiseOnDivideByZero:NO];
-	self.from = [_from decimalNumberByRoundingAccordingToBehavior:roundingBehavior];
-	self.to = [_to decimalNumberByRoundingAccordingToBehavior:roundingBehavior];
-	
+	self.fromDecimal = CHDecimalRound(_fromDecimal, 0, NSRoundUp);
+	self.toDecimal = CHDecimalRound(_toDecimal, 0, NSRoundUp);
 }
 
 - (void)floor
 {
-	NSDecimalNumberHandler *roundingBehavior = [[NSDecimalNumberHandler alloc] initWithRoundingMode:NSRoundDown
-																							  scale:0
-																				   raiseOnExactness:NO
-																					raiseOnOverflow:NO
-																				   raiseOnUnderflow:NO
-																				raiseOnDivideByZero:NO];
-	self.from = [_from decimalNumberByRoundingAccordingToBehavior:roundingBehavior];
-	self.to = [_to decimalNumberByRoundingAccordingToBehavior:roundingBehavior];
-	
+	self.fromDecimal = CHDecimalRound(_fromDecimal, 0, NSRoundDown);
+	self.toDecimal = CHDecimalRound(_toDecimal, 0, NSRoundDown);
 }
 
 
@@ -255,13 +285,13 @@
 				// less than or equal to
 				if ((ltRange.length > 0 && eqRange.length > 0) || lteRange.length > 0) {
 					firstDecimalIsLowerLimit = NO;
-					self.from = [NSDecimalNumber minimumDecimalNumber];
+					self.fromDecimal = CHDecimalMakeInfinity(YES);
 				}
 				
 				// less than
 				else if (ltRange.length > 0) {
 					firstDecimalIsLowerLimit = NO;
-					self.from = [NSDecimalNumber minimumDecimalNumber];
+					self.fromDecimal = CHDecimalMakeInfinity(YES);
 					_includingTo = NO;
 				}
 				
@@ -274,12 +304,12 @@
 					
 					// greater than or equal to
 					if ((gtRange.length > 0 && eqRange.length > 0) || gteRange.length > 0) {
-						self.to = [NSDecimalNumber maximumDecimalNumber];
+						self.toDecimal = CHDecimalMakeInfinity(NO);
 					}
 					
 					// greater than
 					else if (gtRange.length > 0) {
-						self.to = [NSDecimalNumber maximumDecimalNumber];
+						self.toDecimal = CHDecimalMakeInfinity(NO);
 						_includingFrom = NO;
 					}
 				}
@@ -288,10 +318,10 @@
 			// first number
 			if ([scanner scanDecimal:&firstDecimal]) {
 				if (firstDecimalIsLowerLimit) {
-					self.from = [NSDecimalNumber decimalNumberWithDecimal:firstDecimal];
+					self.fromDecimal = CHDecimalFromNSDecimal(firstDecimal);
 				}
 				else {
-					self.to = [NSDecimalNumber decimalNumberWithDecimal:firstDecimal];
+					self.toDecimal = CHDecimalFromNSDecimal(firstDecimal);
 				}
 			}
 			
@@ -305,13 +335,13 @@
 				
 				// second number
 				if ([scanner scanDecimal:&secondDecimal]) {
-					self.to = [NSDecimalNumber decimalNumberWithDecimal:secondDecimal];
+					self.toDecimal = CHDecimalFromNSDecimal(secondDecimal);
 				}
 			}
 			
 			// only one number found, means the range is to match the exact number
 			else if (!foundSigns) {
-				self.to = self.from;
+				self.toDecimal = _fromDecimal;
 			}
 			
 			// ignore the rest in the string
@@ -333,14 +363,15 @@
  */
 - (NSString *)stringValueWithStyle:(PPRangeDisplayStyle)style
 {
-	if (_from && ![_from isEqualToNumber:[NSDecimalNumber minimumDecimalNumber]]) {
-		if (_to && ![_to isEqualToNumber:[NSDecimalNumber maximumDecimalNumber]]) {
-			if ([_to isEqualToNumber:_from]) {
+	if (CHDecimalIsDefined(_fromDecimal) && !CHDecimalIsInfinite(_fromDecimal)) {
+		NSString *fromString = CHDecimalString(_fromDecimal);
+		if (CHDecimalIsDefined(_toDecimal) && !CHDecimalIsInfinite(_toDecimal)) {
+			if (NSOrderedSame == CHDecimalCompare(_toDecimal, _fromDecimal)) {
 				NSString *formatString = (PPRangeDisplayStyleSquareBrackets == style) ? @"[%@]" : @"%@";
-				return [NSString stringWithFormat:formatString, [_from stringValue]];
+				return [NSString stringWithFormat:formatString, fromString];
 			}
 			NSString *formatString = (PPRangeDisplayStyleSquareBrackets == style) ? @"[%@,%@]" : @"%@ - %@";
-			return [NSString stringWithFormat:formatString, [_from stringValue], [_to stringValue]];
+			return [NSString stringWithFormat:formatString, fromString, CHDecimalString(_toDecimal)];
 		}
 		
 		// to is +∞
@@ -351,7 +382,7 @@
 		else {
 			formatString = _includingTo ? @"≥ %@" : @"> %@";
 		}
-		return [NSString stringWithFormat:formatString, [_from stringValue]];
+		return [NSString stringWithFormat:formatString, fromString];
 	}
 	
 	// from is -∞
@@ -362,7 +393,7 @@
 	else {
 		formatString = _includingTo ? @"≤ %@" : @"< %@";
 	}
-	return [NSString stringWithFormat:formatString, _to ? [_to stringValue] : @"∞"];
+	return [NSString stringWithFormat:formatString, (CHDecimalIsDefined(_toDecimal) && !CHDecimalIsInfinite(_toDecimal)) ? CHDecimalString(_toDecimal) : @"∞"];
 }
 
 
@@ -370,7 +401,7 @@
 #pragma mark - Utilities
 - (BOOL)isDefined
 {
-	return (_from != nil || _to != nil);
+	return (CHDecimalIsDefined(_fromDecimal) || CHDecimalIsDefined(_toDecimal));
 }
 
 - (NSString *)description
@@ -7,8 +7,185 @@
 //
 
 #import <Cocoa/Cocoa.h>
+#import <Quartz/Quartz.h>
+#import "CHChart.h"
+#import "CHChartLinter.h"
+#import "CHPlotServer.h"
+#import "CHMeasurementIngest.h"
+
+
+/**
+ *  Lints the chart JSON files given on the command line and prints one JSON object per diagnostic and line to stdout.
+ *
+ *  If there is a PDF with the same name next to a JSON file it is loaded, so page numbers can be checked.
+ *  @return 0 if there were no errors, 1 otherwise
+ */
+static int lintCharts(int argc, const char *argv[])
+{
+	int status = 0;
+	@autoreleasepool {
+		NSMutableArray *charts = [NSMutableArray arrayWithCapacity:argc];
+		for (int i = 2; i < argc; i++) {
+			NSString *path = [NSString stringWithUTF8String:argv[i]];
+			NSData *data = [NSData dataWithContentsOfFile:path];
+			id json = data ? [NSJSONSerialization JSONObjectWithData:data options:0 error:nil] : nil;
+			CHChart *chart = json ? [CHChart newFromJSONObject:json] : nil;
+			if (!chart) {
+				fprintf(stderr, "Failed to read a chart from %s\n", argv[i]);
+				status = 1;
+				continue;
+			}
+			if (!chart.name) {
+				chart.name = [path lastPathComponent];
+			}
+			
+			NSString *pdfPath = [[path stringByDeletingPathExtension] stringByAppendingPathExtension:@"pdf"];
+			if ([[NSFileManager defaultManager] fileExistsAtPath:pdfPath]) {
+				chart.document = [[PDFDocument alloc] initWithURL:[NSURL fileURLWithPath:pdfPath]];
+			}
+			[charts addObject:chart];
+		}
+		
+		NSArray *diagnostics = [[CHChartLinter new] lintCharts:charts];
+		for (CHLintDiagnostic *diag in diagnostics) {
+			NSData *line = [NSJSONSerialization dataWithJSONObject:[diag jsonObject] options:0 error:nil];
+			fwrite([line bytes], 1, [line length], stdout);
+			fputc('\n', stdout);
+			
+			if (CHLintSeverityError == diag.severity) {
+				status = 1;
+			}
+		}
+	}
+	return status;
+}
+
+
+/**
+ *  Serves the bundled charts, plus the chart JSON files given after the socket path, on a Unix socket until killed.
+ *  @return Only returns (with 1) if the server could not be started
+ */
+static int serveCharts(int argc, const char *argv[])
+{
+	if (argc < 3) {
+		fprintf(stderr, "Usage: %s --serve <socket path> [chart.json ...]\n", argv[0]);
+		return 1;
+	}
+	
+	@autoreleasepool {
+		NSMutableArray *charts = [NSMutableArray arrayWithArray:[CHChart bundledCharts]];
+		for (int i = 3; i < argc; i++) {
+			NSData *data = [NSData dataWithContentsOfFile:[NSString stringWithUTF8String:argv[i]]];
+			id json = data ? [NSJSONSerialization JSONObjectWithData:data options:0 error:nil] : nil;
+			CHChart *chart = json ? [CHChart newFromJSONObject:json] : nil;
+			if (!chart) {
+				fprintf(stderr, "Failed to read a chart from %s\n", argv[i]);
+				continue;
+			}
+			[charts addObject:chart];
+		}
+		
+		static CHPlotServer *server = nil;
+		server = [[CHPlotServer alloc] initWithSocketPath:[NSString stringWithUTF8String:argv[2]] charts:charts];
+		NSError *error = nil;
+		if (![server start:&error]) {
+			fprintf(stderr, "Failed to listen on %s: %s\n", argv[2], [[error localizedDescription] UTF8String]);
+			return 1;
+		}
+	}
+	dispatch_main();
+}
+
+
+/**
+ *  Reads a CSV or NDJSON measurement export and prints one JSON object per line to stdout for every rejected row and every implausible value, then a
+ *  summary to stderr. Options are "--birthdate YYYY-MM-DD" for rows without birth date and "--timezone <name>" for dates without offset.
+ *  @return 0 if all rows could be read, 1 otherwise
+ */
+static int ingestMeasurements(int argc, const char *argv[])
+{
+	if (argc < 3) {
+		fprintf(stderr, "Usage: %s --ingest <export.csv|export.ndjson> [--birthdate YYYY-MM-DD] [--timezone <name>]\n", argv[0]);
+		return 1;
+	}
+	
+	int status = 0;
+	@autoreleasepool {
+		CHMeasurementIngest *ingest = [[CHMeasurementIngest alloc] initWithURL:[NSURL fileURLWithPath:[NSString stringWithUTF8String:argv[2]]]];
+		NSString *birthDate = nil;
+		for (int i = 3; i + 1 < argc; i += 2) {
+			NSString *value = [NSString stringWithUTF8String:argv[i + 1]];
+			if (0 == strcmp("--timezone", argv[i])) {
+				ingest.timeZone = [NSTimeZone timeZoneWithName:value];
+				if (!ingest.timeZone) {
+					fprintf(stderr, "Unknown time zone %s\n", argv[i + 1]);
+					return 1;
+				}
+			}
+			else if (0 == strcmp("--birthdate", argv[i])) {
+				birthDate = value;
+			}
+		}
+		
+		// the birth date is local to the export's time zone
+		if (birthDate) {
+			NSDateFormatter *formatter = [NSDateFormatter new];
+			formatter.dateFormat = @"yyyy-MM-dd";
+			formatter.timeZone = ingest.timeZone ? ingest.timeZone : [NSTimeZone defaultTimeZone];
+			ingest.birthDate = [formatter dateFromString:birthDate];
+			if (!ingest.birthDate) {
+				fprintf(stderr, "Invalid birth date %s\n", [birthDate UTF8String]);
+				return 1;
+			}
+		}
+		
+		static const char *statusNames[] = { "ok", "unknown-data-type", "unknown-unit", "invalid-value", "invalid-date", "truncated" };
+		CHStringTable *dataTypes = [CHStringTable sharedTableNamed:@"dataType"];
+		__block NSUInteger numImplausible = 0;
+		NSError *error = nil;
+		BOOL read = [ingest enumerateBatchesUsingBlock:^(CHMeasurementBatch *batch, BOOL *stop) {
+			for (NSUInteger i = 0; i < batch.count; i++) {
+				NSDictionary *report = nil;
+				NSString *dataType = [dataTypes stringForID:batch.dataTypes[i]];
+				if (CHMeasurementStatusOK != batch.statuses[i]) {
+					report = @{@"line": @(batch.lines[i]), @"status": @(statusNames[batch.statuses[i]])};
+				}
+				else if (0 != batch.plausibility[i]) {
+					numImplausible++;
+					report = @{@"line": @(batch.lines[i]), @"status": @"implausible", @"dataType": dataType ? dataType : @"",
+							   @"value": CHDecimalString(batch.values[i]), @"plausibility": @(batch.plausibility[i])};
+				}
+				
+				if (report) {
+					NSData *line = [NSJSONSerialization dataWithJSONObject:report options:0 error:nil];
+					fwrite([line bytes], 1, [line length], stdout);
+					fputc('\n', stdout);
+				}
+			}
+		} error:&error];
+		
+		if (!read) {
+			fprintf(stderr, "Failed to read %s: %s\n", argv[2], [[error localizedDescription] UTF8String]);
+			return 1;
+		}
+		fprintf(stderr, "%lu rows, %lu rejected, %lu implausible, %lu patients\n", (unsigned long)ingest.numRows, (unsigned long)ingest.numRejected,
+				(unsigned long)numImplausible, (unsigned long)ingest.numPatients);
+		status = (ingest.numRejected > 0) ? 1 : 0;
+	}
+	return status;
+}
+
 
 int main(int argc, char *argv[])
 {
+	if (argc > 1 && 0 == strcmp("--lint", argv[1])) {
+		return lintCharts(argc, (const char **)argv);
+	}
+	if (argc > 1 && 0 == strcmp("--serve", argv[1])) {
+		return serveCharts(argc, (const char **)argv);
+	}
+	if (argc > 1 && 0 == strcmp("--ingest", argv[1])) {
+		return ingestMeasurements(argc, (const char **)argv);
+	}
 	return NSApplicationMain(argc, (const char **)argv);
 }